@@ -0,0 +1,20 @@
+#ifndef DFT_H
+#define DFT_H
+
+#include "complex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function to compute DFT
+void compute_dft(Complex *inputBuffer, Complex *outputBuffer, int NDFT);
+
+// Function to compute IDFT, scaled by 1/NDFT
+void compute_idft(Complex *inputBuffer, Complex *outputBuffer, int NDFT);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
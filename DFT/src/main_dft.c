@@ -4,39 +4,7 @@
 #include <string.h>
 #include "../include/complex.h"
 #include "../include/data_utils.h"
-
-// Define M_PI if not defined in math.h
-#ifndef M_PI
-    #define M_PI 3.14159265358979323846
-#endif
-
-// Function to compute DFT
-void compute_dft(Complex *inputBuffer, Complex *outputBuffer, int NDFT) {
-    for (int k = 0; k < NDFT; k++) {
-        outputBuffer[k].real = 0;
-        outputBuffer[k].imag = 0;
-        for (int n = 0; n < NDFT; n++) {
-            float phase = 2.0 * M_PI * k * n / NDFT;
-            outputBuffer[k].real += inputBuffer[n].real * cos(phase) + inputBuffer[n].imag * sin(phase);
-            outputBuffer[k].imag += inputBuffer[n].imag * cos(phase) - inputBuffer[n].real * sin(phase);
-        }
-    }
-}
-
-// Function to compute IDFT
-void compute_idft(Complex *inputBuffer, Complex *outputBuffer, int NDFT) {
-    for (int n = 0; n < NDFT; n++) {
-        outputBuffer[n].real = 0;
-        outputBuffer[n].imag = 0;
-        for (int k = 0; k < NDFT; k++) {
-            float phase = 2.0 * M_PI * k * n / NDFT;
-            outputBuffer[n].real += inputBuffer[k].real * cos(phase) - inputBuffer[k].imag * sin(phase);
-            outputBuffer[n].imag += inputBuffer[k].real * sin(phase) + inputBuffer[k].imag * cos(phase);
-        }
-        outputBuffer[n].real /= NDFT;
-        outputBuffer[n].imag /= NDFT;
-    }
-}
+#include "../include/dft.h"
 
 int main(int argc, char *argv[]) {
     if (argc != 5) {
@@ -0,0 +1,49 @@
+#ifndef CHANNELIZER_H
+#define CHANNELIZER_H
+
+// One complex output sample of a channel
+typedef struct {
+    double real;
+    double imag;
+} ChannelSample;
+
+// Polyphase FFT filter bank: splits a real input into numChannels evenly spaced channels,
+// channel k centred at k / numChannels cycles per sample, each downsampled by decimation.
+//
+// Channel k is the same as down-mixing with exp(-j 2 pi k n / numChannels), filtering
+// with the prototype and keeping every decimation-th sample (ds_main ... iq). Here the
+// prototype of numChannels * tapsPerChannel taps is applied once per output to the delay
+// line and folded into numChannels partial sums; one FFT of them gives all channels. Per
+// input sample that is tapsPerChannel * numChannels / decimation multiplies plus the FFT.
+//
+// decimation = numChannels is critically sampled, numChannels / 2 oversamples by 2 and
+// keeps the transition bands of neighbouring channels from aliasing in. Only channels
+// 0 .. numChannels / 2 are produced, the others are their complex conjugates for a real input.
+typedef struct {
+    int numChannels;         // power of two, >= 4
+    int tapsPerChannel;
+    int decimation;
+    double *prototype;       // numChannels * tapsPerChannel taps, with the output scale, owned
+    double *history;         // mirrored delay line of 2 * numChannels * tapsPerChannel values, owned
+    int historyIndex;        // position of the newest sample
+    int phase;               // input samples since the last output, 0 = the next one produces an output
+    int position;            // input samples so far, modulo numChannels
+    double *folded;          // numChannels partial sums, owned
+    ChannelSample *twiddles; // exp(-j 2 pi k / numChannels), k < numChannels / 2, owned
+    int *bitReverse;         // permutation of the numChannels / 2 point FFT, owned
+} Channelizer;
+
+// Design a Kaiser-windowed prototype with cutoff at half the channel spacing (80 dB
+// stopband) and clear the state. The output has the scale of ds_main ... iq with the
+// same factor. Returns 0 on success, -1 on failure or if numChannels is not a power of two.
+int channelizerInit(Channelizer *channelizer, int numChannels, int tapsPerChannel, int decimation);
+
+// Release prototype, delay line and FFT tables
+void channelizerFree(Channelizer *channelizer);
+
+// Filter one chunk. Every output time writes numChannels / 2 + 1 values, channel after
+// channel, to output. At most (numSamples + decimation - 1) / decimation output times,
+// returns their number.
+int channelizerProcess(Channelizer *channelizer, const double *inputChunk, ChannelSample *output, int numSamples);
+
+#endif
@@ -12,7 +12,13 @@ int read_chunk(FILE *file, double *buffer, int chunkSize);
 // Write output signal in chunks to CSV file
 void write_chunk(FILE *file, double *data, int dataSize);
 
-// Read FIR coefficients from CSV
+// Read complex input in chunks from CSV file, one "I,Q" line per sample
+int read_iq_chunk(FILE *file, double *inPhase, double *quadrature, int chunkSize);
+
+// Write complex output in chunks to CSV file, one "I,Q" line per sample
+void write_iq_chunk(FILE *file, const double *inPhase, const double *quadrature, int dataSize);
+
+// Read FIR coefficients from CSV, closes fp
 void readFIRCoeffsFromFile(FILE *fp, double *coeffs, size_t numFIRCoeffs);
 
-#endif 
\ No newline at end of file
+#endif 
\ No newline at end of file
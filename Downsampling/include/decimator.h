@@ -0,0 +1,39 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include "ds.h"
+
+// Mixer, anti-aliasing FIR and downsampling by factor with all state in the struct.
+//
+// The decimation phase is carried across calls: input sample i of the stream (counted
+// from the first call) produces an output when i % factor == 0, for any chunk size. The
+// filter only runs for those samples, which is the polyphase form of the decimator: each
+// output needs numFIRCoeffs multiplies (half for linear-phase sets), numFIRCoeffs / factor
+// per input sample. The mixer runs at the input rate on a recursive phasor.
+//
+// The delay line holds numFIRCoeffs mixed samples and is stored twice back to back
+// (mirrored), newest first, so the filter window is always contiguous.
+typedef struct {
+    double *firCoeffs;       // owned copy
+    int numFIRCoeffs;
+    FIRSymmetry symmetry;
+    int factor;
+    double *history;         // mirrored delay line of 2*numFIRCoeffs values, owned
+    int historyIndex;        // position of the newest sample
+    int phase;               // input samples since the last output, 0 = the next one produces an output
+    double mixCos, mixSin;       // mixer phasor
+    double mixRotCos, mixRotSin; // rotation by 2*pi*normalizedFmix per sample
+} Decimator;
+
+// Copy the coefficients, clear the delay line and start the mixer at phase zero.
+// Returns 0 on success, -1 on failure.
+int decimatorInit(Decimator *decimator, const double *firCoeffs, int numFIRCoeffs, int factor, double normalizedFmix);
+
+// Release coefficients and delay line
+void decimatorFree(Decimator *decimator);
+
+// Mix, filter and downsample one chunk. Writes at most (numSamples + factor - 1) / factor
+// outputs and returns their number.
+int decimatorProcess(Decimator *decimator, const double *inputChunk, double *outputChunk, int numSamples);
+
+#endif
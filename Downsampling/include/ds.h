@@ -3,7 +3,20 @@
 
 #include <string.h>
 
+// Linear-phase coefficient sets: h[k] = h[N-1-k] (symmetric) or h[k] = -h[N-1-k] (antisymmetric)
+typedef enum {
+    FIR_ASYMMETRIC,
+    FIR_SYMMETRIC,
+    FIR_ANTISYMMETRIC
+} FIRSymmetry;
+
+// Check the coefficients for (anti)symmetry, evaluated once after loading
+FIRSymmetry detectSymmetry(const double *firCoeffs, int numFIRCoeffs);
+
+// Mix, filter and downsample one chunk. Symmetric filters pre-add the mirrored
+// samples of the delay line and need half the multiplies.
 int processSignal( double *input, double *output, double *firCoeffs, double *buffer,
-       int nSamples, int numFIRCoeffs, int bufferSize, int downsamplingFactor, double fmix);
+       int nSamples, int numFIRCoeffs, int bufferSize, int downsamplingFactor, double fmix,
+       FIRSymmetry symmetry);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,18 @@
+#ifndef FIR_DESIGN_H
+#define FIR_DESIGN_H
+
+// Kaiser window parameter for a stopband attenuation in dB (Kaiser's formula)
+double kaiserBeta(double attenuationDb);
+
+// Number of taps a Kaiser-windowed design needs for the attenuation and a transition
+// width in cycles per sample
+int kaiserLength(double attenuationDb, double transitionWidth);
+
+// Kaiser window of length values
+void kaiserWindow(double *window, int length, double beta);
+
+// Linear-phase low-pass: sinc with cutoff in cycles per sample (0.5 = Nyquist) under a
+// Kaiser window, scaled to a DC gain of one. The result is symmetric.
+void designLowpass(double *firCoeffs, int numFIRCoeffs, double cutoff, double beta);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef INTERPOLATOR_H
+#define INTERPOLATOR_H
+
+// Upsampling by factor with an anti-imaging FIR, all state in the struct.
+//
+// Conceptually factor - 1 zeros are inserted after every input sample and the result is
+// filtered. Output n * factor + p only sees the taps p, p + factor, p + 2 * factor, ...
+// against the input samples, so the filter is split into factor phases of tapsPerPhase
+// taps and the zeros are never stored or multiplied: every output costs tapsPerPhase =
+// ceil(numFIRCoeffs / factor) multiplies. The taps are scaled by factor, which makes up
+// for the energy of the zeros, so a filter with a DC gain of one keeps the level.
+//
+// The delay line holds tapsPerPhase input samples and is stored twice back to back
+// (mirrored), newest first, so the filter window is always contiguous.
+typedef struct {
+    double *polyphaseCoeffs; // factor phases of tapsPerPhase taps, phase after phase, zero-padded, owned
+    int tapsPerPhase;
+    int factor;
+    double *history;         // mirrored delay line of 2*tapsPerPhase input samples, owned
+    int historyIndex;        // position of the newest sample
+} Interpolator;
+
+// Split the coefficients (designed at the output rate) into phases and clear the delay line.
+// Returns 0 on success, -1 on failure.
+int interpolatorInit(Interpolator *interpolator, const double *firCoeffs, int numFIRCoeffs, int factor);
+
+// Release coefficients and delay line
+void interpolatorFree(Interpolator *interpolator);
+
+// Upsample one chunk, writes numSamples * factor outputs and returns their number
+int interpolatorProcess(Interpolator *interpolator, const double *inputChunk, double *outputChunk, int numSamples);
+
+#endif
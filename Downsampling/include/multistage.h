@@ -0,0 +1,83 @@
+#ifndef MULTISTAGE_H
+#define MULTISTAGE_H
+
+#include "decimator.h"
+
+#define MAX_DECIMATION_STAGES 16
+
+// Stage types of a decimation cascade, in the order they run
+typedef enum {
+    STAGE_CIC,       // non-recursive CIC, (1 + z^-1)^order and downsampling by 2, log2(factor) times
+    STAGE_HALFBAND,  // half-band FIR, every other tap is zero, downsampling by 2
+    STAGE_FIR        // final FIR with the CIC droop compensation, downsampling by factor
+} DecimationStageType;
+
+typedef struct {
+    DecimationStageType type;
+    int factor;
+    int order;                  // CIC only
+    int numFIRCoeffs;           // half-band and FIR, including the zero taps
+    double multipliesPerInput;  // per sample at the input of the cascade
+} DecimationStagePlan;
+
+// Frequencies are in cycles per input sample. The output keeps [0, passband] and
+// attenuates everything from stopband on by attenuationDb, with stopband at most
+// 0.5 / factor. Every stage attenuates the bands that would alias into [0, stopband].
+typedef struct {
+    int factor;
+    double passband;
+    double stopband;
+    double attenuationDb;
+    DecimationStagePlan stages[MAX_DECIMATION_STAGES];
+    int numStages;
+    double multipliesPerInput;
+} DecimationPlan;
+
+// Try every split factor = 2^m (CIC) * 2^h (half-bands) * F (final FIR) and keep the one
+// with the fewest multiplies per input sample. Returns 0 on success, -1 if the spec
+// is invalid or no split meets it.
+int planDecimation(DecimationPlan *plan, int factor, double passband, double stopband, double attenuationDb);
+
+// Print the stages of a plan
+void printDecimationPlan(const DecimationPlan *plan);
+
+// One half-band stage: centre tap and the distinct nonzero odd taps
+typedef struct {
+    double centre;
+    double *oddCoeffs;       // numOddCoeffs taps at offsets 1, 3, 5, ... from the centre, owned
+    int numOddCoeffs;
+    int numFIRCoeffs;        // 4 * numOddCoeffs - 1
+    double *history;         // mirrored delay line of 2*numFIRCoeffs values, owned
+    int historyIndex;
+    int phase;               // 0 = the next input produces an output
+} HalfbandStage;
+
+// A planned cascade with its state. The mixer runs on the input as in Decimator, all
+// stage gains are folded into the final FIR, so the output has the scale of the
+// single-filter decimator.
+typedef struct {
+    DecimationPlan plan;
+    int cicStages;           // number of (1 + z^-1)^order / 2 sections
+    int cicOrder;
+    double *cicState;        // last input of every (1 + z^-1), cicStages * cicOrder, owned
+    int *cicPhase;           // per section, 0 = the next input is kept, owned
+    HalfbandStage halfbands[MAX_DECIMATION_STAGES];
+    int numHalfbands;
+    Decimator final;         // final FIR, its mixer at zero frequency
+    double *work;            // one chunk of intermediate samples, owned
+    int maxChunk;
+    double mixCos, mixSin;
+    double mixRotCos, mixRotSin;
+} MultistageDecimator;
+
+// Design the filters of the plan and clear all state. Returns 0 on success, -1 on failure.
+int multistageInit(MultistageDecimator *decimator, const DecimationPlan *plan, double normalizedFmix, int maxChunk);
+
+// Release filters and state
+void multistageFree(MultistageDecimator *decimator);
+
+// Mix and decimate one chunk of at most maxChunk samples. Writes at most
+// (numSamples + factor - 1) / factor outputs and returns their number.
+int multistageProcess(MultistageDecimator *decimator, const double *inputChunk, double *outputChunk, int numSamples);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef NCO_H
+#define NCO_H
+
+#include <stdint.h>
+
+// Numerically controlled oscillator. The phase is a 32-bit accumulator, 2^32 is one cycle,
+// so the frequency is exact to 2^-32 of the sample rate and the phase never drifts or
+// needs wrapping. Sine and cosine come from one table of NCO_TABLE_SIZE values over a
+// cycle, linearly interpolated (about -105 dB of phase-to-amplitude error).
+#define NCO_TABLE_BITS 10
+#define NCO_TABLE_SIZE (1 << NCO_TABLE_BITS)
+
+typedef struct {
+    uint32_t phase;
+    uint32_t increment;      // normalizedFreq * 2^32 per sample
+    const double *table;     // shared sine table, NCO_TABLE_SIZE + 1 values
+} NCO;
+
+// Start at phase zero. normalizedFreq is in cycles per sample, negative frequencies wrap.
+void ncoInit(NCO *nco, double normalizedFreq);
+
+// Complex down-mix: inPhase + j * quadrature = input * exp(-j 2 pi f n). A tone at +f
+// lands at zero frequency, its image at -2f is left for the decimating filter.
+void ncoMixDown(NCO *nco, const double *input, double *inPhase, double *quadrature, int numSamples);
+
+// Up-mix back to a real signal: output = Re((inPhase + j * quadrature) * exp(j 2 pi f n)).
+// A baseband tone at zero frequency lands at +f with the same amplitude. With quadrature
+// NULL the input is real and the output is inPhase * cos(2 pi f n).
+void ncoMixUp(NCO *nco, const double *inPhase, const double *quadrature, double *output, int numSamples);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+// Rational sample rate conversion by interpolation / decimation, e.g. 160 / 147 for
+// 44.1 kHz to 48 kHz.
+//
+// Conceptually the input is upsampled by interpolation with zeros, low-pass filtered at
+// the lower of both Nyquist frequencies and downsampled by decimation. The filter of
+// interpolation * tapsPerPhase taps is split into interpolation phases of tapsPerPhase
+// taps. Output m sits at m * decimation upsampled samples, and only the phase that lands
+// there is evaluated, against the original input samples. No zeros are stored or
+// multiplied and no discarded output is computed, so every output costs tapsPerPhase
+// multiplies.
+//
+// The phase position is carried across calls, any chunk size gives the same stream.
+typedef struct {
+    double *polyphaseCoeffs; // interpolation phases of tapsPerPhase taps, phase after phase, owned
+    int tapsPerPhase;
+    int interpolation;       // L, reduced by the greatest common divisor
+    int decimation;          // M
+    double *history;         // mirrored delay line of 2*tapsPerPhase input samples, newest first, owned
+    int historyIndex;        // position of the newest sample
+    int phase;               // upsampled position of the next output after the newest input sample
+} Resampler;
+
+// Design the Kaiser-windowed low-pass (80 dB stopband from the lower Nyquist frequency)
+// and clear the delay line. Returns 0 on success, -1 on failure.
+int resamplerInit(Resampler *resampler, int interpolation, int decimation, int tapsPerPhase);
+
+// Release coefficients and delay line
+void resamplerFree(Resampler *resampler);
+
+// Upper bound of the outputs of one call with numSamples inputs
+int resamplerMaxOutput(const Resampler *resampler, int numSamples);
+
+// Resample one chunk, returns the number of outputs written
+int resamplerProcess(Resampler *resampler, const double *inputChunk, double *outputChunk, int numSamples);
+
+#endif
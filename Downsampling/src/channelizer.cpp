@@ -0,0 +1,198 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/channelizer.h"
+#include "../include/firDesign.h"
+
+// Stopband attenuation of the prototype filter
+static const double CHANNELIZER_ATTENUATION_DB = 80.0;
+
+// In-place complex FFT of numChannels / 2 points, iterative radix-2 decimation in time
+// (as in the LMS module, in double). The half size transform uses every second twiddle.
+static void complexFFT(const Channelizer *channelizer, ChannelSample *data) {
+    int size = channelizer->numChannels;
+    int n = size / 2;
+
+    for (int i = 0; i < n; i++) {
+        int j = channelizer->bitReverse[i];
+        if (j > i) {
+            ChannelSample tmp = data[i];
+            data[i] = data[j];
+            data[j] = tmp;
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        int halfLen = len / 2;
+        int stride = size / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < halfLen; k++) {
+                ChannelSample w = channelizer->twiddles[k * stride];
+                ChannelSample *a = &data[start + k];
+                ChannelSample *b = &data[start + k + halfLen];
+                double tr = b->real * w.real - b->imag * w.imag;
+                double ti = b->real * w.imag + b->imag * w.real;
+                b->real = a->real - tr;
+                b->imag = a->imag - ti;
+                a->real += tr;
+                a->imag += ti;
+            }
+        }
+    }
+}
+
+// Real FFT of numChannels values to numChannels / 2 + 1 bins: pack even/odd values into
+// one complex sequence, transform, then split
+static void realFFT(const Channelizer *channelizer, const double *input, ChannelSample *spectrum) {
+    int half = channelizer->numChannels / 2;
+
+    for (int i = 0; i < half; i++) {
+        spectrum[i].real = input[2 * i];
+        spectrum[i].imag = input[2 * i + 1];
+    }
+    complexFFT(channelizer, spectrum);
+
+    // Bins 0 and numChannels / 2 are purely real
+    double z0r = spectrum[0].real;
+    double z0i = spectrum[0].imag;
+    spectrum[0].real = z0r + z0i;
+    spectrum[0].imag = 0.0;
+    spectrum[half].real = z0r - z0i;
+    spectrum[half].imag = 0.0;
+
+    // Bins k and half-k are computed together so the split can run in place
+    for (int k = 1; k <= half / 2; k++) {
+        int m = half - k;
+        ChannelSample zk = spectrum[k];
+        ChannelSample zm = spectrum[m];
+
+        // Even part E = (Z[k] + conj(Z[m]))/2, odd part O = (Z[k] - conj(Z[m]))/(2j)
+        double ekr = 0.5 * (zk.real + zm.real);
+        double eki = 0.5 * (zk.imag - zm.imag);
+        double okr = 0.5 * (zk.imag + zm.imag);
+        double oki = -0.5 * (zk.real - zm.real);
+        ChannelSample wk = channelizer->twiddles[k];
+        spectrum[k].real = ekr + wk.real * okr - wk.imag * oki;
+        spectrum[k].imag = eki + wk.real * oki + wk.imag * okr;
+
+        if (m != k) {
+            // E[m] = conj(E[k]), O[m] = conj(O[k])
+            ChannelSample wm = channelizer->twiddles[m];
+            spectrum[m].real = ekr + wm.real * okr + wm.imag * oki;
+            spectrum[m].imag = -eki - wm.real * oki + wm.imag * okr;
+        }
+    }
+}
+
+int channelizerInit(Channelizer *channelizer, int numChannels, int tapsPerChannel, int decimation) {
+    int numFIRCoeffs = numChannels * tapsPerChannel;
+    int half = numChannels / 2;
+
+    memset(channelizer, 0, sizeof(*channelizer));
+    if (numChannels < 4 || (numChannels & (numChannels - 1)) != 0 || tapsPerChannel < 1 || decimation < 1) {
+        return -1;
+    }
+    channelizer->numChannels = numChannels;
+    channelizer->tapsPerChannel = tapsPerChannel;
+    channelizer->decimation = decimation;
+    channelizer->prototype = (double*)malloc(numFIRCoeffs * sizeof(double));
+    channelizer->history = (double*)calloc(2 * numFIRCoeffs, sizeof(double));
+    channelizer->folded = (double*)malloc(numChannels * sizeof(double));
+    channelizer->twiddles = (ChannelSample*)malloc(half * sizeof(ChannelSample));
+    channelizer->bitReverse = (int*)malloc(half * sizeof(int));
+    if (!channelizer->prototype || !channelizer->history || !channelizer->folded ||
+        !channelizer->twiddles || !channelizer->bitReverse) {
+        channelizerFree(channelizer);
+        return -1;
+    }
+
+    // Channels are 1 / numChannels apart, the prototype cuts off half way to the next one.
+    // The gain 2 * decimation gives the scale of the mixer and Decimator path.
+    designLowpass(channelizer->prototype, numFIRCoeffs, 0.5 / numChannels, kaiserBeta(CHANNELIZER_ATTENUATION_DB));
+    for (int j = 0; j < numFIRCoeffs; j++) {
+        channelizer->prototype[j] *= 2.0 * decimation;
+    }
+
+    for (int k = 0; k < half; k++) {
+        double phase = -2.0 * M_PI * k / numChannels;
+        channelizer->twiddles[k].real = cos(phase);
+        channelizer->twiddles[k].imag = sin(phase);
+    }
+
+    int bits = 0;
+    while ((1 << bits) < half) {
+        bits++;
+    }
+    for (int i = 0; i < half; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        channelizer->bitReverse[i] = reversed;
+    }
+    return 0;
+}
+
+void channelizerFree(Channelizer *channelizer) {
+    free(channelizer->prototype);
+    free(channelizer->history);
+    free(channelizer->folded);
+    free(channelizer->twiddles);
+    free(channelizer->bitReverse);
+    channelizer->prototype = NULL;
+    channelizer->history = NULL;
+    channelizer->folded = NULL;
+    channelizer->twiddles = NULL;
+    channelizer->bitReverse = NULL;
+}
+
+// Channel k at input time n0 is the sum over j of h[j] x[n0-j] exp(-j 2 pi k (n0-j) / K).
+// The exponential only depends on (n0 - j) mod K, so the taps fold into K partial sums,
+// indexed from the newest sample's position, and one K point DFT gives every channel.
+static void channelizerOutput(Channelizer *channelizer, const double *window, ChannelSample *output) {
+    int numChannels = channelizer->numChannels;
+    int tapsPerChannel = channelizer->tapsPerChannel;
+    int mask = numChannels - 1;
+    const double *prototype = channelizer->prototype;
+    double *folded = channelizer->folded;
+
+    // Taps r, r + K, r + 2K, ... all land in folded[(position - r) mod K]
+    for (int r = 0; r < numChannels; r++) {
+        double accum = 0.0;
+        for (int t = 0; t < tapsPerChannel; t++) {
+            int j = r + t * numChannels;
+            accum += prototype[j] * window[j];
+        }
+        folded[(channelizer->position - r) & mask] = accum;
+    }
+    realFFT(channelizer, folded, output);
+}
+
+int channelizerProcess(Channelizer *channelizer, const double *inputChunk, ChannelSample *output, int numSamples) {
+    int numFIRCoeffs = channelizer->numChannels * channelizer->tapsPerChannel;
+    int numBins = channelizer->numChannels / 2 + 1;
+    int mask = channelizer->numChannels - 1;
+    int decimation = channelizer->decimation;
+    int historyIndex = channelizer->historyIndex;
+    int phase = channelizer->phase;
+    double *history = channelizer->history;
+    int outputIndex = 0;
+
+    for (int n = 0; n < numSamples; n++) {
+        // Step back one position, the newest sample is the first one of the window
+        historyIndex = (historyIndex == 0) ? numFIRCoeffs - 1 : historyIndex - 1;
+        history[historyIndex] = inputChunk[n];
+        history[historyIndex + numFIRCoeffs] = inputChunk[n];
+
+        if (phase == 0) {
+            channelizerOutput(channelizer, history + historyIndex, output + outputIndex * numBins);
+            outputIndex++;
+        }
+        phase = (phase == decimation - 1) ? 0 : phase + 1;
+        channelizer->position = (channelizer->position + 1) & mask;
+    }
+
+    channelizer->historyIndex = historyIndex;
+    channelizer->phase = phase;
+    return outputIndex;
+}
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/data.h"
+#include "../include/channelizer.h"
+
+void cleanup(Channelizer *channelizer, double *inputChunk, ChannelSample *outputChunk, FILE *inputFile, FILE **outputFiles, int numFiles);
+
+// Cleanup function
+void cleanup(Channelizer *channelizer, double *inputChunk, ChannelSample *outputChunk, FILE *inputFile, FILE **outputFiles, int numFiles) {
+    if (channelizer) channelizerFree(channelizer);
+    if (inputChunk) free(inputChunk);
+    if (outputChunk) free(outputChunk);
+    if (inputFile) fclose(inputFile);
+    if (outputFiles) {
+        for (int k = 0; k < numFiles; k++) {
+            if (outputFiles[k]) fclose(outputFiles[k]);
+        }
+        free(outputFiles);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Channel k is written to <output prefix>_<k>.csv as "I,Q" lines, k = 0 .. num channels / 2.
+    // With oversampled the channels are decimated by num channels / 2 instead of num channels.
+    if (argc < 6 || argc > 7) {
+        fprintf(stderr, "Usage: %s <input csv file> <output prefix> <num channels> <taps per channel> <chunk size> [oversampled]\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *inputFileName = argv[1];
+    char *outputPrefix = argv[2];
+    int numChannels = atoi(argv[3]);
+    int tapsPerChannel = atoi(argv[4]);
+    int nSamplesPerChunk = atoi(argv[5]);
+    bool oversampled = false;
+    if (argc > 6) {
+        if (strcmp(argv[6], "oversampled") != 0) {
+            fprintf(stderr, "Invalid option %s. Use 'oversampled'.\n", argv[6]);
+            return 1;
+        }
+        oversampled = true;
+    }
+
+    // Validate arguments
+    if (numChannels < 4 || (numChannels & (numChannels - 1)) != 0) {
+        fprintf(stderr, "Error: The number of channels must be a power of two, at least 4.\n");
+        return 1;
+    }
+    if (tapsPerChannel <= 0 || nSamplesPerChunk <= 0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    // Initialize file pointers for data loading
+    FILE *inputFile = fopen(inputFileName, "r");
+    if (inputFile == NULL) {
+        fprintf(stderr, "Can't open input file!\n");
+        return -1;
+    }
+
+    // One file per channel, the channels above num channels / 2 mirror these for a real input
+    int numBins = numChannels / 2 + 1;
+    FILE **outputFiles = (FILE**)calloc(numBins, sizeof(FILE*));
+    if (!outputFiles) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        fclose(inputFile);
+        return -1;
+    }
+    for (int k = 0; k < numBins; k++) {
+        char outputFileName[1024];
+        snprintf(outputFileName, sizeof(outputFileName), "%s_%d.csv", outputPrefix, k);
+        outputFiles[k] = fopen(outputFileName, "w");
+        if (outputFiles[k] == NULL) {
+            fprintf(stderr, "Can't open output file %s!\n", outputFileName);
+            cleanup(NULL, NULL, NULL, inputFile, outputFiles, numBins);
+            return -1;
+        }
+    }
+
+    // Design the prototype and size the output for the blocks of one chunk
+    int decimation = oversampled ? numChannels / 2 : numChannels;
+    Channelizer channelizer;
+    if (channelizerInit(&channelizer, numChannels, tapsPerChannel, decimation) != 0) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(&channelizer, NULL, NULL, inputFile, outputFiles, numBins);
+        return -1;
+    }
+    int nBlocksPerChunk = (nSamplesPerChunk + decimation - 1) / decimation;
+    double *inputChunk = (double*)malloc(nSamplesPerChunk * sizeof(double));
+    ChannelSample *outputChunk = (ChannelSample*)malloc(nBlocksPerChunk * numBins * sizeof(ChannelSample));
+    if (!inputChunk || !outputChunk) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(&channelizer, inputChunk, outputChunk, inputFile, outputFiles, numBins);
+        return -1;
+    }
+    printf("%d channels, %d taps per channel, decimation by %d\n", numChannels, tapsPerChannel, decimation);
+
+    // Process signal in chunks, every block holds one sample of each channel
+    int num_read = 0;
+    int num_blocks = 0;
+    while ((num_read = read_chunk(inputFile, inputChunk, nSamplesPerChunk)) > 0) {
+        num_blocks = channelizerProcess(&channelizer, inputChunk, outputChunk, num_read);
+        for (int k = 0; k < numBins; k++) {
+            for (int m = 0; m < num_blocks; m++) {
+                const ChannelSample *sample = &outputChunk[m * numBins + k];
+                fprintf(outputFiles[k], "%lf,%lf\n", sample->real, sample->imag);
+            }
+        }
+    }
+
+    // Free memory
+    cleanup(&channelizer, inputChunk, outputChunk, inputFile, outputFiles, numBins);
+    return 0;
+}
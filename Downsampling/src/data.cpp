@@ -21,9 +21,25 @@ int read_chunk(FILE *file, double *buffer, int chunkSize) {
     return count;
 }
 
+// Read a chunk of complex input data
+int read_iq_chunk(FILE *file, double *inPhase, double *quadrature, int chunkSize) {
+    int count = 0;
+    while (count < chunkSize && fscanf(file, "%lf,%lf", &inPhase[count], &quadrature[count]) == 2) {
+        count++;
+    }
+    return count;
+}
+
 // Write a chunk of output data
 void write_chunk(FILE *file, double *data, int dataSize) {
     for (int i = 0; i < dataSize; i++) {
         fprintf(file, "%lf\n", data[i]);
     }
-}
\ No newline at end of file
+}
+
+// Write a chunk of complex output data
+void write_iq_chunk(FILE *file, const double *inPhase, const double *quadrature, int dataSize) {
+    for (int i = 0; i < dataSize; i++) {
+        fprintf(file, "%lf,%lf\n", inPhase[i], quadrature[i]);
+    }
+}
\ No newline at end of file
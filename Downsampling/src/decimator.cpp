@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <math.h>
+#include "../include/decimator.h"
+
+int decimatorInit(Decimator *decimator, const double *firCoeffs, int numFIRCoeffs, int factor, double normalizedFmix) {
+    double phaseIncrement = 2 * M_PI * normalizedFmix;
+
+    decimator->numFIRCoeffs = numFIRCoeffs;
+    decimator->factor = factor;
+    decimator->historyIndex = 0;
+    decimator->phase = 0;
+    decimator->mixCos = 1.0;
+    decimator->mixSin = 0.0;
+    decimator->mixRotCos = cos(phaseIncrement);
+    decimator->mixRotSin = sin(phaseIncrement);
+    decimator->firCoeffs = (double*)malloc(numFIRCoeffs * sizeof(double));
+    decimator->history = (double*)calloc(2 * numFIRCoeffs, sizeof(double));
+    if (!decimator->firCoeffs || !decimator->history) {
+        return -1;
+    }
+    memcpy(decimator->firCoeffs, firCoeffs, numFIRCoeffs * sizeof(double));
+    decimator->symmetry = detectSymmetry(firCoeffs, numFIRCoeffs);
+    return 0;
+}
+
+void decimatorFree(Decimator *decimator) {
+    free(decimator->firCoeffs);
+    free(decimator->history);
+    decimator->firCoeffs = NULL;
+    decimator->history = NULL;
+}
+
+// Convolution sum over the window, newest sample first
+static double windowSum(const double *firCoeffs, const double *window, int numFIRCoeffs, FIRSymmetry symmetry) {
+    double accum = 0.0;
+    if (symmetry == FIR_ASYMMETRIC) {
+        for (int k = 0; k < numFIRCoeffs; k++) {
+            accum += firCoeffs[k] * window[k];
+        }
+        return accum;
+    }
+
+    // Linear phase: pre-add the mirrored samples, one multiply per coefficient pair
+    double sign = (symmetry == FIR_SYMMETRIC) ? 1.0 : -1.0;
+    for (int k = 0; k < numFIRCoeffs / 2; k++) {
+        accum += firCoeffs[k] * (window[k] + sign * window[numFIRCoeffs - 1 - k]);
+    }
+    if (numFIRCoeffs & 1) {
+        accum += firCoeffs[numFIRCoeffs / 2] * window[numFIRCoeffs / 2];
+    }
+    return accum;
+}
+
+int decimatorProcess(Decimator *decimator, const double *inputChunk, double *outputChunk, int numSamples) {
+    int numFIRCoeffs = decimator->numFIRCoeffs;
+    int factor = decimator->factor;
+    int historyIndex = decimator->historyIndex;
+    int phase = decimator->phase;
+    double mixCos = decimator->mixCos;
+    double mixSin = decimator->mixSin;
+    double *history = decimator->history;
+    int outputIndex = 0;
+
+    for (int n = 0; n < numSamples; n++) {
+        // Down-mix with the oscillator at the current phase, then rotate it by one sample
+        double mixed = inputChunk[n] * 2 * mixCos;
+        double nextCos = mixCos * decimator->mixRotCos - mixSin * decimator->mixRotSin;
+        mixSin = mixSin * decimator->mixRotCos + mixCos * decimator->mixRotSin;
+        mixCos = nextCos;
+
+        // Step back one position, the newest sample is the first one of the window
+        historyIndex = (historyIndex == 0) ? numFIRCoeffs - 1 : historyIndex - 1;
+        history[historyIndex] = mixed;
+        history[historyIndex + numFIRCoeffs] = mixed;
+
+        // Only every factor-th input sample is filtered
+        if (phase == 0) {
+            double accum = windowSum(decimator->firCoeffs, history + historyIndex, numFIRCoeffs, decimator->symmetry);
+            outputChunk[outputIndex++] = accum * factor;
+        }
+        phase = (phase == factor - 1) ? 0 : phase + 1;
+    }
+
+    // Rounding makes the phasor length drift slowly, pull it back to one once per chunk
+    double norm = 1.0 / sqrt(mixCos * mixCos + mixSin * mixSin);
+    decimator->mixCos = mixCos * norm;
+    decimator->mixSin = mixSin * norm;
+    decimator->historyIndex = historyIndex;
+    decimator->phase = phase;
+    return outputIndex;
+}
@@ -0,0 +1,27 @@
+#include <stdint.h>
+#include <string.h>
+#include "../include/denormal.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+bool enableFlushToZero(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    // FTZ is bit 15, DAZ is bit 6
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Exponent bits all zero, mantissa not zero
+int countSubnormals(const double *data, int n) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        count += ((bits & 0x7FF0000000000000ull) == 0 && (bits & 0x000FFFFFFFFFFFFFull) != 0) ? 1 : 0;
+    }
+    return count;
+}
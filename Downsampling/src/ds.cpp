@@ -1,9 +1,56 @@
 #include "math.h"
 #include "../include/ds.h"
 
+// Symmetry check within rounding of the largest coefficient
+FIRSymmetry detectSymmetry(const double *firCoeffs, int numFIRCoeffs) {
+    double maxCoeff = 0.0;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        maxCoeff = fmax(maxCoeff, fabs(firCoeffs[k]));
+    }
+    double tolerance = 1e-12 * maxCoeff;
+
+    bool symmetric = true;
+    bool antisymmetric = true;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        double mirrored = firCoeffs[numFIRCoeffs - 1 - k];
+        symmetric = symmetric && fabs(firCoeffs[k] - mirrored) <= tolerance;
+        antisymmetric = antisymmetric && fabs(firCoeffs[k] + mirrored) <= tolerance;
+    }
+
+    if (symmetric) {
+        return FIR_SYMMETRIC;
+    }
+    return antisymmetric ? FIR_ANTISYMMETRIC : FIR_ASYMMETRIC;
+}
+
+// Folded convolution sum: walk from the newest sample backwards and from the
+// oldest sample forwards at the same time, one multiply per coefficient pair
+static double foldedSum(const double *firCoeffs, const double *buffer, int numFIRCoeffs, int bufferSize,
+                        int bufferIndex, double sign) {
+    int newest = bufferIndex;
+    int oldest = bufferIndex - (numFIRCoeffs - 1);
+    if (oldest < 0) {
+        oldest += bufferSize;
+    }
+
+    double accum = 0.0;
+    for (int k = 0; k < numFIRCoeffs / 2; k++) {
+        accum += firCoeffs[k] * (buffer[newest] + sign * buffer[oldest]);
+        newest = (newest == 0) ? bufferSize - 1 : newest - 1;
+        oldest = (oldest == bufferSize - 1) ? 0 : oldest + 1;
+    }
+
+    // Odd length: centre tap without partner
+    if (numFIRCoeffs & 1) {
+        accum += firCoeffs[numFIRCoeffs / 2] * buffer[newest];
+    }
+    return accum;
+}
+
 // Circular buffer FIR Filtering
 int processSignal(double *inputDataChunk, double *outputDataChunk, double *firCoeffs, double *buffer,
-                   int numSamples, int numFIRCoeffs, int bufferSize, int downsamplingFactor, double normalizedFmix) {
+                   int numSamples, int numFIRCoeffs, int bufferSize, int downsamplingFactor, double normalizedFmix,
+                   FIRSymmetry symmetry) {
     static int bufferIndex = 0;  
     static double phase = 0.0;
     int outputIndex = 0.0;
@@ -29,13 +76,19 @@ int processSignal(double *inputDataChunk, double *outputDataChunk, double *firCo
         if(n % downsamplingFactor == 0) {
             // FIR filter cummulator
             double accum = 0.0;
-            int index = bufferIndex;
 
-            // Convolution sum 
-            // we go back in the buffer and increment the coefficients
-            for (int k = 0; k < numFIRCoeffs; k++) {
-                    accum += firCoeffs[k] * buffer[index];
-                    index = (index - 1 + bufferSize) % bufferSize;  
+            if (symmetry != FIR_ASYMMETRIC) {
+                accum = foldedSum(firCoeffs, buffer, numFIRCoeffs, bufferSize, bufferIndex,
+                                  symmetry == FIR_SYMMETRIC ? 1.0 : -1.0);
+            } else {
+                int index = bufferIndex;
+
+                // Convolution sum 
+                // we go back in the buffer and increment the coefficients
+                for (int k = 0; k < numFIRCoeffs; k++) {
+                        accum += firCoeffs[k] * buffer[index];
+                        index = (index - 1 + bufferSize) % bufferSize;  
+                }
             }
 
             // We store only every M-th sample
@@ -3,22 +3,35 @@
 #include <string.h>
 #include "../include/data.h"
 #include "../include/ds.h"
+#include "../include/decimator.h"
+#include "../include/multistage.h"
+#include "../include/nco.h"
+#include "../include/denormal.h"
 
-void cleanup(double *coeffs, double *buffer, double *inputChunk, double *outputChunk, FILE *inputFile, FILE *outputFile);
+void cleanup(double *coeffs, Decimator *decimators, MultistageDecimator *multistages, double *inputChunk,
+             double *mixedChunk, double *outputChunk, FILE *inputFile, FILE *outputFile);
 
-// Cleanup function
-void cleanup(double *coeffs, double *buffer, double *inputChunk, double *outputChunk, FILE *inputFile, FILE *outputFile) {
+// Cleanup function, decimators and multistages hold the real or in-phase path and the quadrature path
+void cleanup(double *coeffs, Decimator *decimators, MultistageDecimator *multistages, double *inputChunk,
+             double *mixedChunk, double *outputChunk, FILE *inputFile, FILE *outputFile) {
     if (coeffs) free(coeffs);
-    if (buffer) free(buffer);
+    for (int p = 0; p < 2; p++) {
+        if (decimators) decimatorFree(&decimators[p]);
+        if (multistages) multistageFree(&multistages[p]);
+    }
     if (inputChunk) free(inputChunk);
+    if (mixedChunk) free(mixedChunk);
     if (outputChunk) free(outputChunk);
     if (inputFile) fclose(inputFile);
     if (outputFile) fclose(outputFile);
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 8) {
-        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <FIR coeffs file> <num FIR coeffs> <chunk size> <downsampling factor> <Normalized mixinf frequency>\n", argv[0]);
+    // With plan <passband> <stopband> <attenuation dB> the filters are designed as a
+    // multistage cascade, the FIR coeffs file and num FIR coeffs are then ignored.
+    // With iq the output is the complex baseband as "I,Q" lines, as IF_main reads them.
+    if (argc < 8 || argc > 15) {
+        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <FIR coeffs file> <num FIR coeffs> <chunk size> <downsampling factor> <Normalized mixinf frequency> [plan <passband> <stopband> <attenuation dB>] [iq] [ftz] [count]\n", argv[0]);
         return 1;
     }
 
@@ -30,13 +43,50 @@ int main(int argc, char *argv[]) {
     int nSamplesPerChunk = atoi(argv[5]);
     int downSamplingFactor = atoi(argv[6]);
     double fmix = atof(argv[7]);
+    bool usePlan = false;
+    double passband = 0.0;
+    double stopband = 0.0;
+    double attenuationDb = 0.0;
+    bool complexOutput = false;
+    bool flushToZero = false;
+    bool countDenormals = false;
+    for (int i = 8; i < argc; i++) {
+        if (strcmp(argv[i], "plan") == 0 && i + 3 < argc) {
+            usePlan = true;
+            passband = atof(argv[++i]);
+            stopband = atof(argv[++i]);
+            attenuationDb = atof(argv[++i]);
+        } else if (strcmp(argv[i], "iq") == 0) {
+            complexOutput = true;
+        } else if (strcmp(argv[i], "ftz") == 0) {
+            flushToZero = true;
+        } else if (strcmp(argv[i], "count") == 0) {
+            countDenormals = true;
+        } else {
+            fprintf(stderr, "Invalid option %s. Use 'plan <passband> <stopband> <attenuation dB>', 'iq', 'ftz' and 'count'.\n", argv[i]);
+            return 1;
+        }
+    }
 
     // Validate arguments
-    if (numFIRCoeffs <= 0 || nSamplesPerChunk <= 0 || downSamplingFactor <= 0 || fmix < 0) {
+    if ((!usePlan && numFIRCoeffs <= 0) || nSamplesPerChunk <= 0 || downSamplingFactor <= 0 || fmix < 0) {
         fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
         return 1;
     }
 
+    if (flushToZero && !enableFlushToZero()) {
+        fprintf(stderr, "Flush-to-zero is not supported on this target, continuing without it\n");
+    }
+
+    // CIC, half-band and FIR split with the fewest multiplies for the spec
+    DecimationPlan plan;
+    if (usePlan) {
+        if (planDecimation(&plan, downSamplingFactor, passband, stopband, attenuationDb) != 0) {
+            return 1;
+        }
+        printDecimationPlan(&plan);
+    }
+
     // Initialize file pointers for data loading
     FILE *inputFile = fopen(inputFileName, "r");
     if (inputFile == NULL) {
@@ -51,52 +101,106 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
-    FILE *firCoeffsFile = fopen(firCoeffsFileName, "r");
-        if (firCoeffsFile == NULL) {
+    FILE *firCoeffsFile = usePlan ? NULL : fopen(firCoeffsFileName, "r");
+        if (!usePlan && firCoeffsFile == NULL) {
         fprintf(stderr, "Can't open output file!\n");
         fclose(inputFile);
         fclose(outputFile);
         return -1;
     }
 
-    // Initialize data arrays
-    int nSamplesPerOutputChunk = nSamplesPerChunk/downSamplingFactor;
-    int bufferSize = nSamplesPerChunk+numFIRCoeffs-1;
-    double *firCoeffs = (double*)malloc(numFIRCoeffs*sizeof(double));
-    double *buffer = (double*)malloc(bufferSize*sizeof(double));
+    // Initialize data arrays. The decimation phase runs on across chunks, so a chunk
+    // that is not a multiple of the factor can hold one output more than chunk / factor.
+    // With iq the in-phase and the quadrature signal each take a path and a half of the buffers.
+    int numPaths = complexOutput ? 2 : 1;
+    int nSamplesPerOutputChunk = (nSamplesPerChunk + downSamplingFactor - 1) / downSamplingFactor;
+    double *firCoeffs = usePlan ? NULL : (double*)malloc(numFIRCoeffs*sizeof(double));
     double *inputChunk = (double*)malloc(nSamplesPerChunk*sizeof(double));
-    double *outputChunk = (double*)malloc(nSamplesPerOutputChunk*sizeof(double));
+    double *mixedChunk = complexOutput ? (double*)malloc(2*nSamplesPerChunk*sizeof(double)) : NULL;
+    double *outputChunk = (double*)malloc(numPaths*nSamplesPerOutputChunk*sizeof(double));
+    Decimator decimators[2] = {};
+    MultistageDecimator multistages[2] = {};
+    NCO nco;
 
     // Check memory allocation
-    if (!firCoeffs || !buffer || !inputChunk || !outputChunk) {
+    if ((!usePlan && !firCoeffs) || !inputChunk || (complexOutput && !mixedChunk) || !outputChunk) {
         fprintf(stderr, "Failed to allocate memory\n");
-        cleanup(firCoeffs, buffer, inputChunk, outputChunk, NULL, NULL);
+        if (firCoeffsFile) fclose(firCoeffsFile);
+        cleanup(firCoeffs, NULL, NULL, inputChunk, mixedChunk, outputChunk, inputFile, outputFile);
         return -1;
     }
 
-    // Initialize buffer to zero
-    memset(buffer, 0, bufferSize * sizeof(double));
-    memset(firCoeffs, 0, numFIRCoeffs * sizeof(double));
+    // Initialize arrays to zero
     memset(inputChunk, 0, nSamplesPerChunk * sizeof(double));
-    memset(outputChunk, 0, nSamplesPerOutputChunk * sizeof(double));
+    memset(outputChunk, 0, numPaths * nSamplesPerOutputChunk * sizeof(double));
 
-    // Read FIR filter coefficients
-    readFIRCoeffsFromFile(firCoeffsFile, firCoeffs, numFIRCoeffs);
+    // The real path mixes inside the decimator. The I/Q paths get the NCO output and run
+    // their mixers at zero frequency, which keeps the scale of the real path.
+    double pathFmix = complexOutput ? 0.0 : fmix;
+    ncoInit(&nco, fmix);
+    if (!usePlan) {
+        // Read FIR filter coefficients, linear-phase sets use the folded convolution
+        memset(firCoeffs, 0, numFIRCoeffs * sizeof(double));
+        readFIRCoeffsFromFile(firCoeffsFile, firCoeffs, numFIRCoeffs);
+    }
+    for (int p = 0; p < numPaths; p++) {
+        int status = usePlan ? multistageInit(&multistages[p], &plan, pathFmix, nSamplesPerChunk)
+                             : decimatorInit(&decimators[p], firCoeffs, numFIRCoeffs, downSamplingFactor, pathFmix);
+        if (status != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            cleanup(firCoeffs, decimators, multistages, inputChunk, mixedChunk, outputChunk, inputFile, outputFile);
+            return -1;
+        }
+    }
+    // The last stage of the cascade is a Decimator as well
+    Decimator *lastStage = usePlan ? &multistages[0].final : &decimators[0];
+    if (!usePlan && decimators[0].symmetry != FIR_ASYMMETRIC) {
+        printf("Using folded convolution for %s FIR coefficients\n", decimators[0].symmetry == FIR_SYMMETRIC ? "symmetric" : "antisymmetric");
+    }
     
     // Process signal in chunks
     // num_read is always <= nSamplesPerChunk
     int num_read = 0;
     int num_processed = 0;
+    int chunkIndex = 0;
+    long totalOutput = 0;
+    long totalBuffer = 0;
     //int num_total = 0;
     while ((num_read = read_chunk(inputFile, inputChunk, nSamplesPerChunk)) > 0) {
         //num_total = num_total + num_read;
         //fprintf(stdout,"Samples processed %d\n", num_total);
-        num_processed = processSignal( inputChunk, outputChunk, firCoeffs, buffer,
-        num_read,numFIRCoeffs, bufferSize, downSamplingFactor, fmix);
-        write_chunk(outputFile, outputChunk, num_processed);
+        const double *pathInput[2] = {inputChunk, NULL};
+        if (complexOutput) {
+            ncoMixDown(&nco, inputChunk, mixedChunk, mixedChunk + nSamplesPerChunk, num_read);
+            pathInput[0] = mixedChunk;
+            pathInput[1] = mixedChunk + nSamplesPerChunk;
+        }
+        for (int p = 0; p < numPaths; p++) {
+            double *pathOutput = outputChunk + p * nSamplesPerOutputChunk;
+            num_processed = usePlan ? multistageProcess(&multistages[p], pathInput[p], pathOutput, num_read)
+                                    : decimatorProcess(&decimators[p], pathInput[p], pathOutput, num_read);
+        }
+        if (complexOutput) {
+            write_iq_chunk(outputFile, outputChunk, outputChunk + nSamplesPerOutputChunk, num_processed);
+        } else {
+            write_chunk(outputFile, outputChunk, num_processed);
+        }
+        if (countDenormals) {
+            int output = countSubnormals(outputChunk, num_processed);
+            int history = countSubnormals(lastStage->history, 2 * lastStage->numFIRCoeffs);
+            if (output > 0 || history > 0) {
+                printf("chunk %d: %d subnormal outputs, %d subnormal buffer samples\n", chunkIndex, output, history);
+            }
+            totalOutput += output;
+            totalBuffer += history;
+        }
+        chunkIndex++;
+    }
+    if (countDenormals) {
+        printf("%d chunks: %ld subnormal outputs, %ld subnormal buffer samples\n", chunkIndex, totalOutput, totalBuffer);
     }
 
     // Free memory
-    cleanup(firCoeffs, buffer, inputChunk, outputChunk, inputFile, outputFile);
+    cleanup(firCoeffs, decimators, multistages, inputChunk, mixedChunk, outputChunk, inputFile, outputFile);
     return 0;
 }
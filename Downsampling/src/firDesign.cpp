@@ -0,0 +1,59 @@
+#include <math.h>
+#include "../include/firDesign.h"
+
+// Modified Bessel function of the first kind, order zero, from its power series
+static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = 0.5 * x;
+    for (int k = 1; k < 64; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < 1e-17 * sum) {
+            break;
+        }
+    }
+    return sum;
+}
+
+double kaiserBeta(double attenuationDb) {
+    if (attenuationDb > 50.0) {
+        return 0.1102 * (attenuationDb - 8.7);
+    }
+    if (attenuationDb >= 21.0) {
+        return 0.5842 * pow(attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+    }
+    return 0.0;
+}
+
+int kaiserLength(double attenuationDb, double transitionWidth) {
+    return (int)ceil((attenuationDb - 7.95) / (14.36 * transitionWidth)) + 1;
+}
+
+void kaiserWindow(double *window, int length, double beta) {
+    double centre = 0.5 * (length - 1);
+    double windowScale = 1.0 / besselI0(beta);
+    for (int k = 0; k < length; k++) {
+        double r = (centre > 0.0) ? (k - centre) / centre : 0.0;
+        window[k] = besselI0(beta * sqrt(fmax(0.0, 1.0 - r * r))) * windowScale;
+    }
+}
+
+void designLowpass(double *firCoeffs, int numFIRCoeffs, double cutoff, double beta) {
+    double centre = 0.5 * (numFIRCoeffs - 1);
+    double sum = 0.0;
+
+    // Window first, the sinc is multiplied in place
+    kaiserWindow(firCoeffs, numFIRCoeffs, beta);
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        double t = k - centre;
+        double sinc = (t == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        firCoeffs[k] *= sinc;
+        sum += firCoeffs[k];
+    }
+
+    // Unit DC gain
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        firCoeffs[k] /= sum;
+    }
+}
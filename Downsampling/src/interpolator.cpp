@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include "../include/interpolator.h"
+
+int interpolatorInit(Interpolator *interpolator, const double *firCoeffs, int numFIRCoeffs, int factor) {
+    int tapsPerPhase = (numFIRCoeffs + factor - 1) / factor;
+
+    interpolator->tapsPerPhase = tapsPerPhase;
+    interpolator->factor = factor;
+    interpolator->historyIndex = 0;
+    interpolator->polyphaseCoeffs = (double*)calloc(factor * tapsPerPhase, sizeof(double));
+    interpolator->history = (double*)calloc(2 * tapsPerPhase, sizeof(double));
+    if (!interpolator->polyphaseCoeffs || !interpolator->history) {
+        return -1;
+    }
+
+    // Phase p holds taps p, p + factor, p + 2 * factor, ..., the last ones of the
+    // short phases stay zero
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        int p = k % factor;
+        int j = k / factor;
+        interpolator->polyphaseCoeffs[p * tapsPerPhase + j] = factor * firCoeffs[k];
+    }
+    return 0;
+}
+
+void interpolatorFree(Interpolator *interpolator) {
+    free(interpolator->polyphaseCoeffs);
+    free(interpolator->history);
+    interpolator->polyphaseCoeffs = NULL;
+    interpolator->history = NULL;
+}
+
+int interpolatorProcess(Interpolator *interpolator, const double *inputChunk, double *outputChunk, int numSamples) {
+    int tapsPerPhase = interpolator->tapsPerPhase;
+    int factor = interpolator->factor;
+    int historyIndex = interpolator->historyIndex;
+    double *history = interpolator->history;
+    int outputIndex = 0;
+
+    for (int n = 0; n < numSamples; n++) {
+        // Step back one position, the newest sample is the first one of the window
+        historyIndex = (historyIndex == 0) ? tapsPerPhase - 1 : historyIndex - 1;
+        history[historyIndex] = inputChunk[n];
+        history[historyIndex + tapsPerPhase] = inputChunk[n];
+        const double *window = history + historyIndex;
+
+        // One output per phase, all from the same window of input samples
+        for (int p = 0; p < factor; p++) {
+            const double *coeffs = interpolator->polyphaseCoeffs + p * tapsPerPhase;
+            double accum = 0.0;
+            for (int j = 0; j < tapsPerPhase; j++) {
+                accum += coeffs[j] * window[j];
+            }
+            outputChunk[outputIndex++] = accum;
+        }
+    }
+
+    interpolator->historyIndex = historyIndex;
+    return outputIndex;
+}
@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../include/multistage.h"
+#include "../include/firDesign.h"
+
+// Higher CIC orders droop too much in the passband to be worth compensating
+static const int MAX_CIC_ORDER = 6;
+static const double MAX_CIC_DROOP_DB = 6.0;
+
+// Kaiser's length estimate can fall a dB or so short, more so with the droop compensation
+// on the final FIR. The FIR stages are designed for this much more attenuation.
+static const double DESIGN_MARGIN_DB = 3.0;
+
+// Longest FIR a plan may use
+static const int MAX_PLAN_FIR_COEFFS = 8191;
+
+// Frequency grid points per tap of the compensation FIR design, fine enough that the
+// sum is the integral to well below the stopband level
+static const int COMPENSATION_GRID_PER_TAP = 64;
+
+// Magnitude of a CIC of factor and order, normalized to one at DC, f in cycles per input sample
+static double cicResponse(double f, int factor, int order) {
+    double x = M_PI * f;
+    if (fabs(sin(x)) < 1e-12) {
+        return 1.0;
+    }
+    return pow(fabs(sin(x * factor) / (factor * sin(x))), order);
+}
+
+static double dbToAmplitude(double db) {
+    return pow(10.0, -db / 20.0);
+}
+
+// Lowest CIC order that attenuates the bands aliasing into [0, stopband] enough,
+// 0 if none does within the droop limit
+static int cicOrderFor(int factor, double passband, double stopband, double attenuationDb) {
+    double alias = 1.0 / factor - stopband;
+    if (alias <= stopband) {
+        return 0;
+    }
+    for (int order = 1; order <= MAX_CIC_ORDER; order++) {
+        if (cicResponse(passband, factor, order) < dbToAmplitude(MAX_CIC_DROOP_DB)) {
+            return 0;
+        }
+        if (cicResponse(alias, factor, order) <= dbToAmplitude(attenuationDb)) {
+            return order;
+        }
+    }
+    return 0;
+}
+
+// Evaluate one split, returns false if a stage cannot meet the spec
+static bool planSplit(DecimationPlan *plan, int cicFactor, int numHalfbands, int finalFactor) {
+    double passband = plan->passband;
+    double stopband = plan->stopband;
+    double attenuationDb = plan->attenuationDb;
+    double designDb = attenuationDb + DESIGN_MARGIN_DB;
+    double rate = 1.0;  // input rate of the current stage, relative to the cascade input
+
+    plan->numStages = 0;
+    plan->multipliesPerInput = 0.0;
+    if (cicFactor > 1) {
+        int order = cicOrderFor(cicFactor, passband, stopband, attenuationDb);
+        if (order == 0) {
+            return false;
+        }
+        DecimationStagePlan *stage = &plan->stages[plan->numStages++];
+        stage->type = STAGE_CIC;
+        stage->factor = cicFactor;
+        stage->order = order;
+        stage->numFIRCoeffs = 0;
+        stage->multipliesPerInput = 0.0;
+        rate /= cicFactor;
+    }
+
+    // Half-bands pass [0, stopband] and stop from rate / 2 - stopband on, the transition
+    // is symmetric around a quarter of their input rate
+    for (int h = 0; h < numHalfbands; h++) {
+        double edge = stopband / rate;
+        if (edge >= 0.25) {
+            return false;
+        }
+        int length = kaiserLength(designDb, 0.5 - 2.0 * edge);
+        int numOddCoeffs = (length + 1 + 3) / 4;
+        DecimationStagePlan *stage = &plan->stages[plan->numStages++];
+        stage->type = STAGE_HALFBAND;
+        stage->factor = 2;
+        stage->order = 0;
+        stage->numFIRCoeffs = 4 * numOddCoeffs - 1;
+        stage->multipliesPerInput = (numOddCoeffs + 1) * 0.5 * rate;
+        plan->multipliesPerInput += stage->multipliesPerInput;
+        rate /= 2;
+    }
+
+    // The final FIR sets the passband and stopband edges, linear phase with an odd length
+    int length = kaiserLength(designDb, (stopband - passband) / rate) | 1;
+    if (length > MAX_PLAN_FIR_COEFFS) {
+        return false;
+    }
+    DecimationStagePlan *stage = &plan->stages[plan->numStages++];
+    stage->type = STAGE_FIR;
+    stage->factor = finalFactor;
+    stage->order = 0;
+    stage->numFIRCoeffs = length;
+    stage->multipliesPerInput = (length + 1) / 2 * rate / finalFactor;
+    plan->multipliesPerInput += stage->multipliesPerInput;
+    return true;
+}
+
+int planDecimation(DecimationPlan *plan, int factor, double passband, double stopband, double attenuationDb) {
+    if (factor <= 0 || passband <= 0.0 || stopband <= passband || stopband > 0.5 / factor || attenuationDb <= 0.0) {
+        fprintf(stderr, "Invalid decimation spec: factor %d, passband %g, stopband %g (at most %g), %g dB\n", factor,
+                passband, stopband, 0.5 / factor, attenuationDb);
+        return -1;
+    }
+    plan->factor = factor;
+    plan->passband = passband;
+    plan->stopband = stopband;
+    plan->attenuationDb = attenuationDb;
+
+    DecimationPlan best;
+    best.numStages = 0;
+    for (int cicFactor = 1; factor % cicFactor == 0; cicFactor *= 2) {
+        for (int halfbandFactor = 1; factor % (cicFactor * halfbandFactor) == 0; halfbandFactor *= 2) {
+            int numHalfbands = 0;
+            while ((1 << numHalfbands) < halfbandFactor) {
+                numHalfbands++;
+            }
+            if (numHalfbands + 2 > MAX_DECIMATION_STAGES) {
+                break;
+            }
+
+            // Fewest multiplies, on a tie the shorter cascade
+            DecimationPlan candidate = *plan;
+            if (planSplit(&candidate, cicFactor, numHalfbands, factor / (cicFactor * halfbandFactor)) &&
+                (best.numStages == 0 || candidate.multipliesPerInput < best.multipliesPerInput - 1e-9 ||
+                 (candidate.multipliesPerInput < best.multipliesPerInput + 1e-9 && candidate.numStages < best.numStages))) {
+                best = candidate;
+            }
+        }
+    }
+    if (best.numStages == 0) {
+        fprintf(stderr, "No decimation cascade meets the spec\n");
+        return -1;
+    }
+    *plan = best;
+    return 0;
+}
+
+void printDecimationPlan(const DecimationPlan *plan) {
+    printf("Decimation by %d, passband %g, stopband %g, %g dB: %.2f multiplies per input sample\n", plan->factor,
+           plan->passband, plan->stopband, plan->attenuationDb, plan->multipliesPerInput);
+    for (int s = 0; s < plan->numStages; s++) {
+        const DecimationStagePlan *stage = &plan->stages[s];
+        if (stage->type == STAGE_CIC) {
+            printf("  CIC       factor %4d  order %d           %.2f multiplies\n", stage->factor, stage->order,
+                   stage->multipliesPerInput);
+        } else {
+            printf("  %-9s factor %4d  %5d taps          %.2f multiplies\n",
+                   stage->type == STAGE_HALFBAND ? "half-band" : "FIR", stage->factor, stage->numFIRCoeffs,
+                   stage->multipliesPerInput);
+        }
+    }
+}
+
+// Low-pass with the inverse CIC response up to the middle of the transition band, sampled
+// on a dense grid and windowed. The window spreads the edge over the transition band as in
+// designLowpass. Edges are in cycles per sample at the FIR input, rateDivider is the
+// decimation in front of it. Returns 0 on success, -1 on failure.
+static int designCompensator(double *firCoeffs, int numFIRCoeffs, double passband, double stopband, int cicFactor,
+                             int cicOrder, int rateDivider, double beta) {
+    double centre = 0.5 * (numFIRCoeffs - 1);
+    int gridSize = COMPENSATION_GRID_PER_TAP * numFIRCoeffs;
+    double df = 0.5 * (passband + stopband) / gridSize;
+
+    double *desired = (double*)malloc(gridSize * sizeof(double));
+    if (!desired) {
+        return -1;
+    }
+    for (int i = 0; i < gridSize; i++) {
+        desired[i] = 1.0 / cicResponse((i + 0.5) * df / rateDivider, cicFactor, cicOrder);
+    }
+
+    // Inverse transform of the real, even response: 2 * integral of D(f) cos(2 pi f t),
+    // the cosine from a phasor rotated by one grid step
+    kaiserWindow(firCoeffs, numFIRCoeffs, beta);
+    double sum = 0.0;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        double t = k - centre;
+        double rotCos = cos(2.0 * M_PI * df * t);
+        double rotSin = sin(2.0 * M_PI * df * t);
+        double phasorCos = cos(M_PI * df * t);
+        double phasorSin = sin(M_PI * df * t);
+        double accum = 0.0;
+        for (int i = 0; i < gridSize; i++) {
+            accum += desired[i] * phasorCos;
+            double nextCos = phasorCos * rotCos - phasorSin * rotSin;
+            phasorSin = phasorSin * rotCos + phasorCos * rotSin;
+            phasorCos = nextCos;
+        }
+        firCoeffs[k] *= 2.0 * accum * df;
+        sum += firCoeffs[k];
+    }
+    free(desired);
+
+    // Unit DC gain, as the CIC response is one there
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        firCoeffs[k] /= sum;
+    }
+    return 0;
+}
+
+int multistageInit(MultistageDecimator *decimator, const DecimationPlan *plan, double normalizedFmix, int maxChunk) {
+    double phaseIncrement = 2 * M_PI * normalizedFmix;
+    double beta = kaiserBeta(plan->attenuationDb + DESIGN_MARGIN_DB);
+    int cicFactor = 1;
+    int halfbandFactor = 1;
+    double cicGain = 1.0;
+    int status = 0;
+
+    decimator->plan = *plan;
+    decimator->cicStages = 0;
+    decimator->cicOrder = 0;
+    decimator->cicState = NULL;
+    decimator->cicPhase = NULL;
+    decimator->numHalfbands = 0;
+    decimator->final.firCoeffs = NULL;
+    decimator->final.history = NULL;
+    decimator->maxChunk = maxChunk;
+    decimator->mixCos = 1.0;
+    decimator->mixSin = 0.0;
+    decimator->mixRotCos = cos(phaseIncrement);
+    decimator->mixRotSin = sin(phaseIncrement);
+    decimator->work = (double*)malloc(maxChunk * sizeof(double));
+    if (!decimator->work) {
+        return -1;
+    }
+
+    for (int s = 0; s < plan->numStages && status == 0; s++) {
+        const DecimationStagePlan *stage = &plan->stages[s];
+        if (stage->type == STAGE_CIC) {
+            while ((1 << decimator->cicStages) < stage->factor) {
+                decimator->cicStages++;
+            }
+            decimator->cicOrder = stage->order;
+            decimator->cicState = (double*)calloc(decimator->cicStages * stage->order, sizeof(double));
+            decimator->cicPhase = (int*)calloc(decimator->cicStages, sizeof(int));
+            status = (decimator->cicState && decimator->cicPhase) ? 0 : -1;
+            cicFactor = stage->factor;
+            cicGain = ldexp(1.0, decimator->cicStages * stage->order);
+        } else if (stage->type == STAGE_HALFBAND) {
+            // Windowed sinc at a quarter of the rate, its even taps are zero
+            HalfbandStage *halfband = &decimator->halfbands[decimator->numHalfbands++];
+            int numFIRCoeffs = stage->numFIRCoeffs;
+            halfband->numFIRCoeffs = numFIRCoeffs;
+            halfband->numOddCoeffs = (numFIRCoeffs + 1) / 4;
+            halfband->historyIndex = 0;
+            halfband->phase = 0;
+            halfband->oddCoeffs = (double*)malloc(halfband->numOddCoeffs * sizeof(double));
+            halfband->history = (double*)calloc(2 * numFIRCoeffs, sizeof(double));
+            double *prototype = (double*)malloc(numFIRCoeffs * sizeof(double));
+            if (!halfband->oddCoeffs || !halfband->history || !prototype) {
+                free(prototype);
+                status = -1;
+                break;
+            }
+            designLowpass(prototype, numFIRCoeffs, 0.25, beta);
+            int centre = numFIRCoeffs / 2;
+            halfband->centre = prototype[centre];
+            for (int j = 0; j < halfband->numOddCoeffs; j++) {
+                halfband->oddCoeffs[j] = prototype[centre + 2 * j + 1];
+            }
+            free(prototype);
+            halfbandFactor *= 2;
+        } else {
+            double *firCoeffs = (double*)malloc(stage->numFIRCoeffs * sizeof(double));
+            if (!firCoeffs) {
+                status = -1;
+                break;
+            }
+            int rateDivider = cicFactor * halfbandFactor;
+            if (designCompensator(firCoeffs, stage->numFIRCoeffs, plan->passband * rateDivider,
+                                  plan->stopband * rateDivider, cicFactor, decimator->cicOrder, rateDivider, beta) != 0) {
+                free(firCoeffs);
+                status = -1;
+                break;
+            }
+
+            // The Decimator scales by 2 (mixer at zero frequency) and by its factor. Take
+            // that and the CIC gain out and put the total factor of the cascade in.
+            double gain = (double)plan->factor / (2.0 * stage->factor * cicGain);
+            for (int k = 0; k < stage->numFIRCoeffs; k++) {
+                firCoeffs[k] *= gain;
+            }
+            status = decimatorInit(&decimator->final, firCoeffs, stage->numFIRCoeffs, stage->factor, 0.0);
+            free(firCoeffs);
+        }
+    }
+    return status;
+}
+
+void multistageFree(MultistageDecimator *decimator) {
+    free(decimator->cicState);
+    free(decimator->cicPhase);
+    for (int h = 0; h < decimator->numHalfbands; h++) {
+        free(decimator->halfbands[h].oddCoeffs);
+        free(decimator->halfbands[h].history);
+    }
+    decimatorFree(&decimator->final);
+    free(decimator->work);
+    decimator->cicState = NULL;
+    decimator->cicPhase = NULL;
+    decimator->numHalfbands = 0;
+    decimator->work = NULL;
+}
+
+// One (1 + z^-1)^order section and downsampling by 2, in place. Adds only.
+static int cicSection(double *data, int numSamples, double *state, int order, int *phase) {
+    int outputIndex = 0;
+    int keep = *phase;
+    for (int n = 0; n < numSamples; n++) {
+        double value = data[n];
+        for (int k = 0; k < order; k++) {
+            double sum = value + state[k];
+            state[k] = value;
+            value = sum;
+        }
+        if (keep == 0) {
+            data[outputIndex++] = value;
+        }
+        keep ^= 1;
+    }
+    *phase = keep;
+    return outputIndex;
+}
+
+// Half-band filter and downsampling by 2, in place. Only the kept samples are filtered,
+// with the odd taps folded around the centre.
+static int halfbandProcess(HalfbandStage *halfband, double *data, int numSamples) {
+    int numFIRCoeffs = halfband->numFIRCoeffs;
+    int numOddCoeffs = halfband->numOddCoeffs;
+    int centre = numFIRCoeffs / 2;
+    int historyIndex = halfband->historyIndex;
+    int phase = halfband->phase;
+    double *history = halfband->history;
+    int outputIndex = 0;
+
+    for (int n = 0; n < numSamples; n++) {
+        // Step back one position, the newest sample is the first one of the window
+        historyIndex = (historyIndex == 0) ? numFIRCoeffs - 1 : historyIndex - 1;
+        history[historyIndex] = data[n];
+        history[historyIndex + numFIRCoeffs] = data[n];
+
+        if (phase == 0) {
+            const double *window = history + historyIndex;
+            double accum = halfband->centre * window[centre];
+            for (int j = 0; j < numOddCoeffs; j++) {
+                accum += halfband->oddCoeffs[j] * (window[centre - 2 * j - 1] + window[centre + 2 * j + 1]);
+            }
+            data[outputIndex++] = accum;
+        }
+        phase ^= 1;
+    }
+
+    halfband->historyIndex = historyIndex;
+    halfband->phase = phase;
+    return outputIndex;
+}
+
+int multistageProcess(MultistageDecimator *decimator, const double *inputChunk, double *outputChunk, int numSamples) {
+    double *work = decimator->work;
+    double mixCos = decimator->mixCos;
+    double mixSin = decimator->mixSin;
+
+    // Down-mix at the input rate, as in Decimator
+    for (int n = 0; n < numSamples; n++) {
+        work[n] = inputChunk[n] * 2 * mixCos;
+        double nextCos = mixCos * decimator->mixRotCos - mixSin * decimator->mixRotSin;
+        mixSin = mixSin * decimator->mixRotCos + mixCos * decimator->mixRotSin;
+        mixCos = nextCos;
+    }
+    double norm = 1.0 / sqrt(mixCos * mixCos + mixSin * mixSin);
+    decimator->mixCos = mixCos * norm;
+    decimator->mixSin = mixSin * norm;
+
+    // Every stage shrinks the chunk in place
+    int length = numSamples;
+    for (int c = 0; c < decimator->cicStages; c++) {
+        length = cicSection(work, length, decimator->cicState + c * decimator->cicOrder, decimator->cicOrder,
+                            &decimator->cicPhase[c]);
+    }
+    for (int h = 0; h < decimator->numHalfbands; h++) {
+        length = halfbandProcess(&decimator->halfbands[h], work, length);
+    }
+    return decimatorProcess(&decimator->final, work, outputChunk, length);
+}
@@ -0,0 +1,73 @@
+#include <math.h>
+#include "../include/nco.h"
+
+// Bits of the phase below the table index, used for the interpolation
+static const int NCO_FRACTION_BITS = 32 - NCO_TABLE_BITS;
+static const uint32_t NCO_QUARTER_CYCLE = 1u << 30;
+
+typedef struct {
+    double values[NCO_TABLE_SIZE + 1];
+} SineTable;
+
+// One extra value at the end, so the interpolation never wraps
+static SineTable buildSineTable(void) {
+    SineTable table;
+    for (int k = 0; k <= NCO_TABLE_SIZE; k++) {
+        table.values[k] = sin(2.0 * M_PI * k / NCO_TABLE_SIZE);
+    }
+    return table;
+}
+
+// Built once on first use, shared by all oscillators
+static const double *sineTable(void) {
+    static const SineTable table = buildSineTable();
+    return table.values;
+}
+
+static inline double tableSine(const double *table, uint32_t phase) {
+    uint32_t index = phase >> NCO_FRACTION_BITS;
+    double fraction = (phase & ((1u << NCO_FRACTION_BITS) - 1)) * (1.0 / (1u << NCO_FRACTION_BITS));
+    return table[index] + fraction * (table[index + 1] - table[index]);
+}
+
+void ncoInit(NCO *nco, double normalizedFreq) {
+    // Reduce to [0, 1) first, then to the 32-bit phase step
+    double cycles = normalizedFreq - floor(normalizedFreq);
+    nco->phase = 0;
+    nco->increment = (uint32_t)(int64_t)llround(cycles * 4294967296.0);
+    nco->table = sineTable();
+}
+
+void ncoMixDown(NCO *nco, const double *input, double *inPhase, double *quadrature, int numSamples) {
+    const double *table = nco->table;
+    uint32_t phase = nco->phase;
+    uint32_t increment = nco->increment;
+
+    for (int n = 0; n < numSamples; n++) {
+        // cos(x) = sin(x + pi/2), exp(-jx) = cos(x) - j sin(x)
+        double c = tableSine(table, phase + NCO_QUARTER_CYCLE);
+        double s = tableSine(table, phase);
+        inPhase[n] = input[n] * c;
+        quadrature[n] = -input[n] * s;
+        phase += increment;
+    }
+    nco->phase = phase;
+}
+
+void ncoMixUp(NCO *nco, const double *inPhase, const double *quadrature, double *output, int numSamples) {
+    const double *table = nco->table;
+    uint32_t phase = nco->phase;
+    uint32_t increment = nco->increment;
+
+    for (int n = 0; n < numSamples; n++) {
+        // Re((I + jQ)(cos(x) + j sin(x))) = I cos(x) - Q sin(x)
+        double c = tableSine(table, phase + NCO_QUARTER_CYCLE);
+        if (quadrature) {
+            output[n] = inPhase[n] * c - quadrature[n] * tableSine(table, phase);
+        } else {
+            output[n] = inPhase[n] * c;
+        }
+        phase += increment;
+    }
+    nco->phase = phase;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/data.h"
+#include "../include/resampler.h"
+
+void cleanup(Resampler *resampler, double *inputChunk, double *outputChunk, FILE *inputFile, FILE *outputFile);
+
+// Cleanup function
+void cleanup(Resampler *resampler, double *inputChunk, double *outputChunk, FILE *inputFile, FILE *outputFile) {
+    if (resampler) resamplerFree(resampler);
+    if (inputChunk) free(inputChunk);
+    if (outputChunk) free(outputChunk);
+    if (inputFile) fclose(inputFile);
+    if (outputFile) fclose(outputFile);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 6 || argc > 7) {
+        fprintf(stderr, "Usage: %s <input csv file> <output csv file> <interpolation factor L> <decimation factor M> <chunk size> [taps per phase]\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments, e.g. L = 160, M = 147 for 44.1 kHz to 48 kHz
+    char *inputFileName = argv[1];
+    char *outputFileName = argv[2];
+    int interpolation = atoi(argv[3]);
+    int decimation = atoi(argv[4]);
+    int nSamplesPerChunk = atoi(argv[5]);
+    int tapsPerPhase = (argc > 6) ? atoi(argv[6]) : 32;
+
+    // Validate arguments
+    if (interpolation <= 0 || decimation <= 0 || nSamplesPerChunk <= 0 || tapsPerPhase <= 0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    // Initialize file pointers for data loading
+    FILE *inputFile = fopen(inputFileName, "r");
+    if (inputFile == NULL) {
+        fprintf(stderr, "Can't open input file!\n");
+        return -1;
+    }
+
+    FILE *outputFile = fopen(outputFileName, "w");
+    if (outputFile == NULL) {
+        fprintf(stderr, "Can't open output file!\n");
+        fclose(inputFile);
+        return -1;
+    }
+
+    // Design the polyphase filter, then size the output chunk for the ratio
+    Resampler resampler = {};
+    if (resamplerInit(&resampler, interpolation, decimation, tapsPerPhase) != 0) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(&resampler, NULL, NULL, inputFile, outputFile);
+        return -1;
+    }
+    int nSamplesPerOutputChunk = resamplerMaxOutput(&resampler, nSamplesPerChunk);
+    double *inputChunk = (double*)malloc(nSamplesPerChunk * sizeof(double));
+    double *outputChunk = (double*)malloc(nSamplesPerOutputChunk * sizeof(double));
+    if (!inputChunk || !outputChunk) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(&resampler, inputChunk, outputChunk, inputFile, outputFile);
+        return -1;
+    }
+    printf("Resampling by %d/%d, %d taps per phase\n", resampler.interpolation, resampler.decimation, tapsPerPhase);
+
+    // Process signal in chunks
+    int num_read = 0;
+    int num_processed = 0;
+    while ((num_read = read_chunk(inputFile, inputChunk, nSamplesPerChunk)) > 0) {
+        num_processed = resamplerProcess(&resampler, inputChunk, outputChunk, num_read);
+        write_chunk(outputFile, outputChunk, num_processed);
+    }
+
+    // Free memory
+    cleanup(&resampler, inputChunk, outputChunk, inputFile, outputFile);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/resampler.h"
+#include "../include/firDesign.h"
+
+// Stopband attenuation of the anti-imaging / anti-aliasing filter
+static const double RESAMPLER_ATTENUATION_DB = 80.0;
+
+static int greatestCommonDivisor(int a, int b) {
+    while (b != 0) {
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+int resamplerInit(Resampler *resampler, int interpolation, int decimation, int tapsPerPhase) {
+    int divisor = greatestCommonDivisor(interpolation, decimation);
+    interpolation /= divisor;
+    decimation /= divisor;
+    int numFIRCoeffs = interpolation * tapsPerPhase;
+
+    resampler->tapsPerPhase = tapsPerPhase;
+    resampler->interpolation = interpolation;
+    resampler->decimation = decimation;
+    resampler->historyIndex = 0;
+    resampler->phase = 0;
+    resampler->polyphaseCoeffs = (double*)malloc(numFIRCoeffs * sizeof(double));
+    resampler->history = (double*)calloc(2 * tapsPerPhase, sizeof(double));
+    double *prototype = (double*)malloc(numFIRCoeffs * sizeof(double));
+    if (!resampler->polyphaseCoeffs || !resampler->history || !prototype) {
+        free(prototype);
+        return -1;
+    }
+
+    // The transition band ends at the lower Nyquist frequency, in cycles per upsampled sample,
+    // so images and aliases are attenuated by the full stopband
+    int rateFactor = (interpolation > decimation) ? interpolation : decimation;
+    double nyquist = 0.5 / rateFactor;
+    double transitionWidth = (RESAMPLER_ATTENUATION_DB - 7.95) / (14.36 * (numFIRCoeffs - 1));
+    double cutoff = fmax(nyquist - 0.5 * transitionWidth, 0.5 * nyquist);
+    designLowpass(prototype, numFIRCoeffs, cutoff, kaiserBeta(RESAMPLER_ATTENUATION_DB));
+
+    // Phase p holds taps p, p + L, p + 2L, ..., with the gain L that the zeros take away
+    for (int p = 0; p < interpolation; p++) {
+        for (int j = 0; j < tapsPerPhase; j++) {
+            resampler->polyphaseCoeffs[p * tapsPerPhase + j] = interpolation * prototype[p + j * interpolation];
+        }
+    }
+    free(prototype);
+    return 0;
+}
+
+void resamplerFree(Resampler *resampler) {
+    free(resampler->polyphaseCoeffs);
+    free(resampler->history);
+    resampler->polyphaseCoeffs = NULL;
+    resampler->history = NULL;
+}
+
+int resamplerMaxOutput(const Resampler *resampler, int numSamples) {
+    long upsampled = (long)numSamples * resampler->interpolation;
+    return (int)((upsampled + resampler->decimation - 1) / resampler->decimation);
+}
+
+int resamplerProcess(Resampler *resampler, const double *inputChunk, double *outputChunk, int numSamples) {
+    int tapsPerPhase = resampler->tapsPerPhase;
+    int interpolation = resampler->interpolation;
+    int decimation = resampler->decimation;
+    int historyIndex = resampler->historyIndex;
+    int phase = resampler->phase;
+    double *history = resampler->history;
+    int outputIndex = 0;
+
+    for (int n = 0; n < numSamples; n++) {
+        // Step back one position, the newest sample is the first one of the window
+        historyIndex = (historyIndex == 0) ? tapsPerPhase - 1 : historyIndex - 1;
+        history[historyIndex] = inputChunk[n];
+        history[historyIndex + tapsPerPhase] = inputChunk[n];
+        const double *window = history + historyIndex;
+
+        // Every output between this input sample and the next one, none for some
+        // samples when decimating, several when interpolating
+        while (phase < interpolation) {
+            const double *coeffs = resampler->polyphaseCoeffs + phase * tapsPerPhase;
+            double accum = 0.0;
+            for (int j = 0; j < tapsPerPhase; j++) {
+                accum += coeffs[j] * window[j];
+            }
+            outputChunk[outputIndex++] = accum;
+            phase += decimation;
+        }
+        phase -= interpolation;
+    }
+
+    resampler->historyIndex = historyIndex;
+    resampler->phase = phase;
+    return outputIndex;
+}
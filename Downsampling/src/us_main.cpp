@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/data.h"
+#include "../include/interpolator.h"
+#include "../include/nco.h"
+
+void cleanup(double *coeffs, Interpolator *interpolators, double *inputChunk, double *upsampledChunk,
+             double *outputChunk, FILE *inputFile, FILE *outputFile);
+
+// Cleanup function, interpolators hold the real or in-phase path and the quadrature path
+void cleanup(double *coeffs, Interpolator *interpolators, double *inputChunk, double *upsampledChunk,
+             double *outputChunk, FILE *inputFile, FILE *outputFile) {
+    if (coeffs) free(coeffs);
+    for (int p = 0; p < 2; p++) {
+        if (interpolators) interpolatorFree(&interpolators[p]);
+    }
+    if (inputChunk) free(inputChunk);
+    if (upsampledChunk) free(upsampledChunk);
+    if (outputChunk) free(outputChunk);
+    if (inputFile) fclose(inputFile);
+    if (outputFile) fclose(outputFile);
+}
+
+int main(int argc, char *argv[]) {
+    // The mixing frequency is in cycles per output sample, 0 leaves the signal at baseband.
+    // With iq the input is a complex baseband of "I,Q" lines, as ds_main ... iq writes them,
+    // and the output is the real part after the up-mix.
+    if (argc < 8 || argc > 9) {
+        fprintf(stderr, "Usage: %s <input csv file> <output csv file> <FIR coeffs file> <num FIR coeffs> <chunk size> <upsampling factor> <Normalized mixing frequency> [iq]\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *inputFileName = argv[1];
+    char *outputFileName = argv[2];
+    char *firCoeffsFileName = argv[3];
+    int numFIRCoeffs = atoi(argv[4]);
+    int nSamplesPerChunk = atoi(argv[5]);
+    int upSamplingFactor = atoi(argv[6]);
+    double fmix = atof(argv[7]);
+    bool complexInput = false;
+    if (argc > 8) {
+        if (strcmp(argv[8], "iq") != 0) {
+            fprintf(stderr, "Invalid option %s. Use 'iq'.\n", argv[8]);
+            return 1;
+        }
+        complexInput = true;
+    }
+
+    // Validate arguments
+    if (numFIRCoeffs <= 0 || nSamplesPerChunk <= 0 || upSamplingFactor <= 0 || fmix < 0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    // Initialize file pointers for data loading
+    FILE *inputFile = fopen(inputFileName, "r");
+    if (inputFile == NULL) {
+        fprintf(stderr, "Can't open input file!\n");
+        return -1;
+    }
+
+    FILE *outputFile = fopen(outputFileName, "w");
+    if (outputFile == NULL) {
+        fprintf(stderr, "Can't open output file!\n");
+        fclose(inputFile);
+        return -1;
+    }
+
+    FILE *firCoeffsFile = fopen(firCoeffsFileName, "r");
+    if (firCoeffsFile == NULL) {
+        fprintf(stderr, "Can't open FIR coeffs file!\n");
+        fclose(inputFile);
+        fclose(outputFile);
+        return -1;
+    }
+
+    // Initialize data arrays. Every input sample gives factor outputs. With iq the in-phase
+    // and the quadrature signal each take a path and a half of the input and upsampled buffers.
+    int numPaths = complexInput ? 2 : 1;
+    int nSamplesPerOutputChunk = nSamplesPerChunk * upSamplingFactor;
+    double *firCoeffs = (double*)malloc(numFIRCoeffs * sizeof(double));
+    double *inputChunk = (double*)malloc(numPaths * nSamplesPerChunk * sizeof(double));
+    double *upsampledChunk = (double*)malloc(numPaths * nSamplesPerOutputChunk * sizeof(double));
+    double *outputChunk = (double*)malloc(nSamplesPerOutputChunk * sizeof(double));
+    Interpolator interpolators[2] = {};
+    NCO nco;
+
+    // Check memory allocation
+    if (!firCoeffs || !inputChunk || !upsampledChunk || !outputChunk) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        fclose(firCoeffsFile);
+        cleanup(firCoeffs, NULL, inputChunk, upsampledChunk, outputChunk, inputFile, outputFile);
+        return -1;
+    }
+
+    // Read FIR filter coefficients, designed at the output rate. The reader closes the file.
+    memset(firCoeffs, 0, numFIRCoeffs * sizeof(double));
+    readFIRCoeffsFromFile(firCoeffsFile, firCoeffs, numFIRCoeffs);
+    firCoeffsFile = NULL;
+    for (int p = 0; p < numPaths; p++) {
+        if (interpolatorInit(&interpolators[p], firCoeffs, numFIRCoeffs, upSamplingFactor) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            cleanup(firCoeffs, interpolators, inputChunk, upsampledChunk, outputChunk, inputFile, outputFile);
+            return -1;
+        }
+    }
+    ncoInit(&nco, fmix);
+
+    // Process signal in chunks
+    // num_read is always <= nSamplesPerChunk
+    int num_read = 0;
+    int num_processed = 0;
+    while ((num_read = complexInput ? read_iq_chunk(inputFile, inputChunk, inputChunk + nSamplesPerChunk, nSamplesPerChunk)
+                                    : read_chunk(inputFile, inputChunk, nSamplesPerChunk)) > 0) {
+        for (int p = 0; p < numPaths; p++) {
+            num_processed = interpolatorProcess(&interpolators[p], inputChunk + p * nSamplesPerChunk,
+                                                upsampledChunk + p * nSamplesPerOutputChunk, num_read);
+        }
+
+        // The up-mix runs at the output rate, after the anti-imaging filter
+        if (fmix == 0 && !complexInput) {
+            write_chunk(outputFile, upsampledChunk, num_processed);
+            continue;
+        }
+        ncoMixUp(&nco, upsampledChunk, complexInput ? upsampledChunk + nSamplesPerOutputChunk : NULL, outputChunk,
+                 num_processed);
+        write_chunk(outputFile, outputChunk, num_processed);
+    }
+
+    // Free memory
+    cleanup(firCoeffs, interpolators, inputChunk, upsampledChunk, outputChunk, inputFile, outputFile);
+    return 0;
+}
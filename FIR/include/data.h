@@ -9,4 +9,7 @@
 // read FIR coefficients from CSV. The values are stored as column vector.
 void readFIRCoeffsFromFile(const char *fileName, float *coeffs, size_t numFIRCoeffs);
 
-#endif 
\ No newline at end of file
+// Count the FIR coefficients in a CSV file. Returns -1 if the file can't be opened.
+int countFIRCoeffsInFile(const char *fileName);
+
+#endif 
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef DENORMAL_H
+#define DENORMAL_H
+
+#include <stdbool.h>
+
+// Set flush-to-zero (FTZ) and denormals-are-zero (DAZ) in MXCSR. Subnormal results
+// become zero and subnormal inputs are read as zero, so silent input can no longer
+// slow the filters down. Call it at the start of main, threads created afterwards
+// inherit the mode. Returns false on targets without MXCSR.
+bool enableFlushToZero(void);
+
+// Number of subnormal values in data, checked on the bit pattern so it also works with DAZ set
+int countSubnormals(const float *data, int n);
+
+#endif
@@ -2,8 +2,36 @@
 #define FIR_H
 
 #include <string.h>
+#include "firKernels.h"
 
-void processSignal( float *input, float *output, float *firCoeffs, float *buffer,
-       int nSamples, int numFIRCoeffs, int bufferSize);
+// FIR filter instance. The coefficients are only referenced, so any number of
+// instances can share one coefficient set. Delay line and write position are
+// private to each instance, so different instances can run on different threads.
+//
+// The delay line is stored twice back to back (mirrored), newest sample first.
+// The last numFIRCoeffs samples are then always the contiguous window
+// buffer[bufferIndex .. bufferIndex+numFIRCoeffs-1], so the convolution sum is a
+// plain dot product without any index wrapping.
+typedef struct {
+    const float *firCoeffs;  // shared, not owned
+    int numFIRCoeffs;
+    float *buffer;           // mirrored delay line of 2*numFIRCoeffs samples, owned
+    int bufferIndex;
+    FIRDotKernel dot;        // selected for the coefficient symmetry and host CPU in firInit
+} FIRFilter;
 
-#endif
\ No newline at end of file
+// Bind a coefficient set and allocate a zeroed delay line. The coefficients must be
+// loaded already, they are checked for linear-phase symmetry to pick the kernel.
+// Returns 0 on success, -1 on failure.
+int firInit(FIRFilter *filter, const float *firCoeffs, int numFIRCoeffs);
+
+// Clear the delay line and restart at position zero
+void firReset(FIRFilter *filter);
+
+// Release the delay line (the coefficients stay with the caller)
+void firFree(FIRFilter *filter);
+
+// Filter one chunk of samples, the filter state is carried over to the next call
+void processSignal(FIRFilter *filter, const float *input, float *output, int nSamples);
+
+#endif
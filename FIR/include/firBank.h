@@ -0,0 +1,32 @@
+#ifndef FIR_BANK_H
+#define FIR_BANK_H
+
+#include "firKernels.h"
+
+// Bank of FIR filters fed by one input signal. All bands share one linear delay
+// line holding the last numFIRCoeffs-1 samples followed by the current block.
+// The coefficients are stored time-reversed and right aligned in rows of the longest
+// filter, so every output is a dot product of one coefficient row with a contiguous
+// window of the delay line. The dot product of a shorter band starts behind its
+// leading zeros, so each band only pays for its own taps. A block is computed in
+// tiles of a few dozen samples, all bands per tile, so the window stays in cache
+// while the rows stream past.
+typedef struct {
+    int numBands;
+    int numFIRCoeffs;    // longest filter of the bank
+    int maxBlock;
+    float *bankCoeffs;   // numBands x numFIRCoeffs, reversed
+    int *bandOffsets;    // leading zeros of each row, numFIRCoeffs - taps of the band, owned
+    FIRDotKernel *dots;  // kernel for the tap count of each band, owned
+    float *buffer;       // numFIRCoeffs-1 history samples + maxBlock new samples
+} FIRBank;
+
+// Copy the coefficient sets into the bank. Returns 0 on success, -1 on failure.
+int firBankInit(FIRBank *bank, const float *const *firCoeffs, const int *numFIRCoeffs, int numBands, int maxBlock);
+
+void firBankFree(FIRBank *bank);
+
+// Filter up to maxBlock samples, outputs[b] receives band b
+void processBank(FIRBank *bank, const float *input, float *const *outputs, int nSamples);
+
+#endif
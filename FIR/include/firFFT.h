@@ -0,0 +1,37 @@
+#ifndef FIR_FFT_H
+#define FIR_FFT_H
+
+#include "fft.h"
+
+// Overlap-save fast convolution. Each FFT of fftSize points yields
+// blockSize = fftSize - numFIRCoeffs + 1 new output samples. Input is collected
+// until a block is full, so the output is delayed by blockSize samples (latency).
+typedef struct {
+    FFTPlan plan;
+    int numFIRCoeffs;
+    int fftSize;
+    int blockSize;
+    int latency;
+    Complex *coeffSpectrum;  // spectrum of the zero padded coefficients, computed once
+    Complex *spectrum;       // work spectrum
+    float *timeBuffer;       // last numFIRCoeffs-1 inputs followed by the current block
+    float *outputBlock;      // result of the previous block, handed out while the next one fills
+    int blockIndex;          // samples collected in the current block
+} FIRFFTFilter;
+
+// Precompute the coefficient spectrum. fftSize 0 picks the cheapest size per output sample.
+// Returns 0 on success, -1 on failure.
+int firFFTInit(FIRFFTFilter *filter, const float *firCoeffs, int numFIRCoeffs, int fftSize);
+
+void firFFTFree(FIRFFTFilter *filter);
+
+// Stream a chunk of any length through the filter. Output sample n belongs to input n - latency.
+void firFFTProcess(FIRFFTFilter *filter, const float *input, float *output, int nSamples);
+
+// Time direct form against overlap-save on this machine and return the smallest
+// tap count up to maxTaps at which overlap-save is faster. Powers of two are swept
+// first, then the bracket around the crossover is bisected to 1/16 of its width.
+// Returns maxTaps+1 if direct form wins everywhere.
+int firFFTThreshold(int maxTaps);
+
+#endif
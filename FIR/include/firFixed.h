@@ -0,0 +1,50 @@
+#ifndef FIR_FIXED_H
+#define FIR_FIXED_H
+
+#include <stdint.h>
+
+// Coefficient quantization: round to nearest or truncate towards minus infinity
+typedef enum {
+    QUANT_ROUND,
+    QUANT_TRUNCATE
+} QuantMode;
+
+// Float <-> Q15/Q31 with saturation at the format limits
+int16_t floatToQ15(float value, QuantMode mode);
+int32_t floatToQ31(float value, QuantMode mode);
+float q15ToFloat(int16_t value);
+float q31ToFloat(int32_t value);
+
+// Fixed-point FIR filters. Samples are Q15 or Q31. Coefficients use the same word
+// length with coeffShift integer bits, so taps with magnitude >= 1 still fit
+// (coefficient format Q(15-coeffShift) or Q(31-coeffShift)). The delay line is
+// mirrored like in FIRFilter. Products are summed in a 64-bit accumulator with
+// saturating adds and the result is rounded and saturated to the sample format.
+typedef struct {
+    int16_t *firCoeffs;  // quantized, owned
+    int numFIRCoeffs;
+    int coeffShift;
+    int16_t *buffer;     // mirrored delay line of 2*numFIRCoeffs samples
+    int bufferIndex;
+} FIRFilterQ15;
+
+typedef struct {
+    int32_t *firCoeffs;
+    int numFIRCoeffs;
+    int coeffShift;
+    int32_t *buffer;
+    int bufferIndex;
+} FIRFilterQ31;
+
+// Quantize the float coefficients and allocate the delay line. Returns 0 on success, -1 on failure.
+int firInitQ15(FIRFilterQ15 *filter, const float *firCoeffs, int numFIRCoeffs, QuantMode mode);
+int firInitQ31(FIRFilterQ31 *filter, const float *firCoeffs, int numFIRCoeffs, QuantMode mode);
+
+void firFreeQ15(FIRFilterQ15 *filter);
+void firFreeQ31(FIRFilterQ31 *filter);
+
+// Filter one chunk, the filter state is carried over to the next call
+void processSignalQ15(FIRFilterQ15 *filter, const int16_t *input, int16_t *output, int nSamples);
+void processSignalQ31(FIRFilterQ31 *filter, const int32_t *input, int32_t *output, int nSamples);
+
+#endif
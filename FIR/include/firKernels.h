@@ -0,0 +1,48 @@
+#ifndef FIR_KERNELS_H
+#define FIR_KERNELS_H
+
+// Dot product of the coefficients with a contiguous window of the delay line
+typedef float (*FIRDotKernel)(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+
+typedef struct {
+    const char *name;
+    FIRDotKernel dot;
+} FIRKernelInfo;
+
+// Linear-phase designs have h[k] = h[N-1-k] (symmetric) or h[k] = -h[N-1-k]
+// (antisymmetric). Their kernels add or subtract the mirrored samples first
+// and need only half the multiplies.
+typedef enum {
+    FIR_ASYMMETRIC,
+    FIR_SYMMETRIC,
+    FIR_ANTISYMMETRIC
+} FIRSymmetry;
+
+// Check the coefficients for (anti)symmetry within float rounding of the largest tap
+FIRSymmetry firDetectSymmetry(const float *firCoeffs, int numFIRCoeffs);
+
+// Portable reference kernel
+float firDotScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+float firDotSymmetricScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+float firDotAntisymmetricScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+
+#if defined(__x86_64__) || defined(__i386__)
+float firDotSSE(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+float firDotAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+float firDotAVX512(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+float firDotSymmetricAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+float firDotAntisymmetricAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs);
+#endif
+
+// Kernel with the tap count fixed at compile time (15, 31, 63, 127 and 255 taps).
+// Returns false if there is no specialization for numFIRCoeffs.
+bool firFixedKernel(FIRSymmetry symmetry, int numFIRCoeffs, FIRKernelInfo *kernel);
+
+// List the kernels for this symmetry and tap count the host CPU can run, fastest last.
+// Returns the number of entries.
+int firAvailableKernels(FIRKernelInfo *kernels, int maxKernels, FIRSymmetry symmetry, int numFIRCoeffs);
+
+// Fastest kernel for the symmetry, tap count and host CPU
+FIRKernelInfo firSelectKernel(FIRSymmetry symmetry, int numFIRCoeffs);
+
+#endif
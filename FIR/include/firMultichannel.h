@@ -0,0 +1,34 @@
+#ifndef FIR_MULTICHANNEL_H
+#define FIR_MULTICHANNEL_H
+
+// Computes all lanes of one output frame from the window of the delay line
+typedef void (*FIRLaneKernel)(const float *laneCoeffs, const float *window, float *outputFrame,
+                              int numFIRCoeffs, int numLanes);
+
+// Direct form FIR for interleaved multichannel audio with the channels in SIMD lanes.
+// Every channel has its own delay line, they are stored frame by frame (same layout
+// as the interleaved input) and mirrored like in FIRFilter, so the last numFIRCoeffs
+// frames are one contiguous block of numFIRCoeffs*numLanes samples. With AVX2 a frame
+// is padded with silent lanes to 1, 2, 4, 8 or a multiple of 8 lanes, so 3, 5.1 or
+// 12 channel files use the vector kernels as well.
+typedef struct {
+    int numFIRCoeffs;
+    int numChannels;
+    int numLanes;        // samples per stored frame, numChannels plus the silent lanes
+    float *laneCoeffs;   // coefficient k repeated for every channel, zero padded to full vectors
+    float *buffer;       // mirrored delay line of 2*numFIRCoeffs frames, owned
+    float *laneFrame;    // one output frame of numLanes values, owned
+    int bufferIndex;     // frame index of the newest frame
+    FIRLaneKernel kernel;
+} FIRMultiFilter;
+
+// Copy the coefficients into the lane layout and allocate the delay lines.
+// Returns 0 on success, -1 on failure.
+int firMultiInit(FIRMultiFilter *filter, const float *firCoeffs, int numFIRCoeffs, int numChannels);
+
+void firMultiFree(FIRMultiFilter *filter);
+
+// Filter numFrames interleaved frames, the filter state is carried over to the next call
+void processMultichannel(FIRMultiFilter *filter, const float *input, float *output, int numFrames);
+
+#endif
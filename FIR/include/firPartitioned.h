@@ -0,0 +1,34 @@
+#ifndef FIR_PARTITIONED_H
+#define FIR_PARTITIONED_H
+
+#include "fft.h"
+
+// Uniformly partitioned overlap-save convolution. The coefficients are split into
+// numPartitions blocks of partitionSize taps, each with its own spectrum of
+// 2*partitionSize points. Input spectra are kept in a frequency-domain delay line
+// (FDL), so every block costs two FFTs plus one complex multiply-add per partition
+// and bin, and the latency is partitionSize samples instead of the filter length.
+typedef struct {
+    FFTPlan plan;
+    int numFIRCoeffs;
+    int partitionSize;
+    int numPartitions;
+    int latency;
+    Complex *coeffSpectra;   // numPartitions x (partitionSize+1) bins
+    Complex *fdl;            // numPartitions x (partitionSize+1) input spectra, ring buffer
+    int fdlIndex;            // slot of the newest input spectrum
+    Complex *accum;          // partitionSize+1 bins
+    float *timeBuffer;       // previous block followed by the current block
+    float *outputBlock;      // 2*partitionSize samples, the last partitionSize are valid
+    int blockIndex;          // samples collected in the current block
+} FIRPartitionedFilter;
+
+// partitionSize must be a power of two. Returns 0 on success, -1 on failure.
+int firPartitionedInit(FIRPartitionedFilter *filter, const float *firCoeffs, int numFIRCoeffs, int partitionSize);
+
+void firPartitionedFree(FIRPartitionedFilter *filter);
+
+// Stream a chunk of any length through the filter. Output sample n belongs to input n - latency.
+void firPartitionedProcess(FIRPartitionedFilter *filter, const float *input, float *output, int nSamples);
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sndfile.h>
+#include "../include/data.h"
+#include "../include/firBank.h"
+
+#define MAX_BANDS 64
+
+int main(int argc, char *argv[]) {
+    if (argc < 5 || argc - 4 > MAX_BANDS) {
+        fprintf(stderr, "Usage: %s <input wav file> <output prefix> <buffer size> <FIR coeffs file 1> [<FIR coeffs file 2> ...]\n", argv[0]);
+        fprintf(stderr, "Band k is written to <output prefix>_band<k>.wav, at most %d bands.\n", MAX_BANDS);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *inputFile = argv[1];
+    char *outputPrefix = argv[2];
+    int nSamples = atoi(argv[3]);
+    int numBands = argc - 4;
+    if (nSamples <= 0) {
+        fprintf(stderr, "Error: Invalid buffer size.\n");
+        return 1;
+    }
+
+    float *firCoeffs[MAX_BANDS] = {0};
+    int numFIRCoeffs[MAX_BANDS] = {0};
+    SNDFILE *outfiles[MAX_BANDS] = {0};
+    FIRBank *banks = NULL;
+    float *inputChunk = NULL;
+    float *channelInput = NULL;
+    float *channelOutputs = NULL;
+    float *outputChunk = NULL;
+    SNDFILE *infile = NULL;
+    SF_INFO sfinfo;
+    sf_count_t num_read;
+    int numChannels = 0;
+    int status = -1;
+
+    // Read all coefficient sets
+    for (int b = 0; b < numBands; b++) {
+        char *fileName = argv[4 + b];
+        numFIRCoeffs[b] = countFIRCoeffsInFile(fileName);
+        if (numFIRCoeffs[b] <= 0) {
+            fprintf(stderr, "No FIR coefficients in %s\n", fileName);
+            goto done;
+        }
+        firCoeffs[b] = (float*)malloc(numFIRCoeffs[b] * sizeof(float));
+        if (!firCoeffs[b]) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            goto done;
+        }
+        readFIRCoeffsFromFile(fileName, firCoeffs[b], numFIRCoeffs[b]);
+        printf("Band %d: %d coefficients from %s\n", b, numFIRCoeffs[b], fileName);
+    }
+
+    // Input WAV file pointer, decoded only once for all bands
+    infile = sf_open(inputFile, SFM_READ, &sfinfo);
+    if (!infile) {
+        fprintf(stderr, "Could not open input file: %s\n", inputFile);
+        goto done;
+    }
+    numChannels = sfinfo.channels;
+
+    // One output WAV file per band
+    for (int b = 0; b < numBands; b++) {
+        char outputFile[1024];
+        SF_INFO outinfo = sfinfo;
+        snprintf(outputFile, sizeof(outputFile), "%s_band%d.wav", outputPrefix, b);
+        outfiles[b] = sf_open(outputFile, SFM_WRITE, &outinfo);
+        if (!outfiles[b]) {
+            fprintf(stderr, "Could not open output file: %s\n", outputFile);
+            goto done;
+        }
+    }
+
+    // One bank (shared delay line of all bands) per channel
+    banks = (FIRBank*)calloc(numChannels, sizeof(FIRBank));
+    inputChunk = (float*)malloc(nSamples * numChannels * sizeof(float));
+    channelInput = (float*)malloc(nSamples * sizeof(float));
+    channelOutputs = (float*)malloc(numBands * numChannels * nSamples * sizeof(float));
+    outputChunk = (float*)malloc(nSamples * numChannels * sizeof(float));
+    if (!banks || !inputChunk || !channelInput || !channelOutputs || !outputChunk) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        goto done;
+    }
+    for (int ch = 0; ch < numChannels; ch++) {
+        if (firBankInit(&banks[ch], firCoeffs, numFIRCoeffs, numBands, nSamples) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            goto done;
+        }
+    }
+
+    // Process audio file in chunks, all bands in one pass over the input
+    while ((num_read = sf_readf_float(infile, inputChunk, nSamples)) > 0) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            float *outputs[MAX_BANDS];
+            for (int b = 0; b < numBands; b++) {
+                outputs[b] = channelOutputs + (b * numChannels + ch) * nSamples;
+            }
+            for (int n = 0; n < num_read; n++) {
+                channelInput[n] = inputChunk[n * numChannels + ch];
+            }
+            processBank(&banks[ch], channelInput, outputs, num_read);
+        }
+
+        for (int b = 0; b < numBands; b++) {
+            for (int n = 0; n < num_read; n++) {
+                for (int ch = 0; ch < numChannels; ch++) {
+                    outputChunk[n * numChannels + ch] = channelOutputs[(b * numChannels + ch) * nSamples + n];
+                }
+            }
+            sf_writef_float(outfiles[b], outputChunk, num_read);
+        }
+    }
+    status = 0;
+
+done:
+    // Free memory
+    for (int ch = 0; banks && ch < numChannels; ch++) {
+        firBankFree(&banks[ch]);
+    }
+    for (int b = 0; b < numBands; b++) {
+        free(firCoeffs[b]);
+        if (outfiles[b]) sf_close(outfiles[b]);
+    }
+    free(banks);
+    free(inputChunk);
+    free(channelInput);
+    free(channelOutputs);
+    free(outputChunk);
+    if (infile) sf_close(infile);
+    return status;
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../include/fir.h"
+#include "../include/firPartitioned.h"
+
+// Filter a range of channels for a fixed number of chunks.
+// Every channel has its own FIRFilter, all of them share one coefficient set.
+static void runChannels(FIRFilter *filters, int firstChannel, int lastChannel, const float *inputChunk,
+                        float *outputChunk, int nSamples, int numChunks) {
+    for (int c = 0; c < numChunks; c++) {
+        for (int ch = firstChannel; ch < lastChannel; ch++) {
+            processSignal(&filters[ch], inputChunk, outputChunk, nSamples);
+        }
+    }
+}
+
+// Original circular buffer convolution, used as reference for the kernels
+static void processSignalReference(const float *inputDataChunk, float *outputDataChunk, const float *firCoeffs,
+                                   float *buffer, int numSamples, int numFIRCoeffs, int bufferSize, int *bufferIndex) {
+    for (int n = 0; n < numSamples; n++) {
+        buffer[*bufferIndex] = inputDataChunk[n];
+        float accum = 0.0;
+        int index = *bufferIndex;
+        for (int k = 0; k < numFIRCoeffs; k++) {
+            accum += firCoeffs[k] * buffer[index];
+            index = (index - 1 + bufferSize) % bufferSize;
+        }
+        outputDataChunk[n] = accum;
+        *bufferIndex = (*bufferIndex + 1) % bufferSize;
+    }
+}
+
+// Run every kernel the host supports against the reference over several chunks.
+// Returns the number of kernels that exceed the tolerance.
+static int verifyKernels(const float *firCoeffs, int numFIRCoeffs, int nSamples) {
+    const int numChunks = 8;
+    int bufferSize = nSamples + numFIRCoeffs - 1;
+    std::vector<float> input(nSamples * numChunks);
+    std::vector<float> expected(input.size());
+    std::vector<float> actual(input.size());
+    std::vector<float> buffer(bufferSize, 0.0f);
+    int bufferIndex = 0;
+
+    for (size_t n = 0; n < input.size(); n++) {
+        input[n] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    for (int c = 0; c < numChunks; c++) {
+        processSignalReference(&input[c * nSamples], &expected[c * nSamples], firCoeffs, buffer.data(),
+                               nSamples, numFIRCoeffs, bufferSize, &bufferIndex);
+    }
+
+    // Summation order differs, so allow a few ulps of the largest possible output
+    float coeffSum = 0.0f;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        coeffSum += fabsf(firCoeffs[k]);
+    }
+    float tolerance = 0.5f * coeffSum * numFIRCoeffs * 1.2e-7f;
+
+    FIRKernelInfo kernels[5];
+    int numKernels = firAvailableKernels(kernels, 5, firDetectSymmetry(firCoeffs, numFIRCoeffs), numFIRCoeffs);
+    int failures = 0;
+    for (int i = 0; i < numKernels; i++) {
+        FIRFilter filter;
+        if (firInit(&filter, firCoeffs, numFIRCoeffs) != 0) {
+            return numKernels;
+        }
+        filter.dot = kernels[i].dot;
+        for (int c = 0; c < numChunks; c++) {
+            processSignal(&filter, &input[c * nSamples], &actual[c * nSamples], nSamples);
+        }
+        firFree(&filter);
+
+        float maxError = 0.0f;
+        for (size_t n = 0; n < input.size(); n++) {
+            maxError = fmaxf(maxError, fabsf(actual[n] - expected[n]));
+        }
+        bool ok = maxError <= tolerance;
+        failures += ok ? 0 : 1;
+        printf("kernel %-16s max error %.3g (tolerance %.3g) %s\n", kernels[i].name, maxError, tolerance, ok ? "ok" : "FAILED");
+    }
+    return failures;
+}
+
+// Latency and CPU time per block of the partitioned engine for every partition size
+static void reportPartitions(const float *firCoeffs, int numFIRCoeffs) {
+    const int numBlocks = 64;
+    printf("partitioned convolution, taps=%d\n", numFIRCoeffs);
+    printf("%10s %11s %14s %14s %14s\n", "partition", "partitions", "latency ms@48k", "us/block", "ns/sample");
+
+    for (int partitionSize = 32; partitionSize <= 8192; partitionSize *= 2) {
+        FIRPartitionedFilter filter;
+        if (firPartitionedInit(&filter, firCoeffs, numFIRCoeffs, partitionSize) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            return;
+        }
+
+        std::vector<float> input(partitionSize);
+        std::vector<float> output(partitionSize);
+        for (int n = 0; n < partitionSize; n++) {
+            input[n] = (float)rand() / RAND_MAX - 0.5f;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; b++) {
+            firPartitionedProcess(&filter, input.data(), output.data(), partitionSize);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%10d %11d %14.2f %14.2f %14.2f\n", partitionSize, filter.numPartitions,
+               filter.latency * 1e3 / 48000.0, seconds * 1e6 / numBlocks, seconds * 1e9 / numBlocks / partitionSize);
+        firPartitionedFree(&filter);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Usage: %s <num FIR coeffs> <buffer size> <num channels> <num chunks>\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    int numFIRCoeffs = atoi(argv[1]);
+    int nSamples = atoi(argv[2]);
+    int numChannels = atoi(argv[3]);
+    int numChunks = atoi(argv[4]);
+    if (numFIRCoeffs <= 0 || nSamples <= 0 || numChannels <= 0 || numChunks <= 0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads <= 0) {
+        maxThreads = 1;
+    }
+
+    // One shared coefficient set, random test signal
+    std::vector<float> firCoeffs(numFIRCoeffs);
+    std::vector<float> inputChunk(nSamples);
+    srand(1);
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        firCoeffs[k] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    for (int n = 0; n < nSamples; n++) {
+        inputChunk[n] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    // Compare the SIMD kernels with the original convolution, also for
+    // symmetric and antisymmetric versions of the coefficients
+    std::vector<float> symmetricCoeffs(firCoeffs);
+    std::vector<float> antisymmetricCoeffs(firCoeffs);
+    for (int k = 0; k < numFIRCoeffs / 2; k++) {
+        symmetricCoeffs[numFIRCoeffs - 1 - k] = firCoeffs[k];
+        antisymmetricCoeffs[numFIRCoeffs - 1 - k] = -firCoeffs[k];
+    }
+    if (numFIRCoeffs & 1) {
+        antisymmetricCoeffs[numFIRCoeffs / 2] = 0.0f;
+    }
+    if (verifyKernels(firCoeffs.data(), numFIRCoeffs, nSamples) != 0 ||
+        verifyKernels(symmetricCoeffs.data(), numFIRCoeffs, nSamples) != 0 ||
+        verifyKernels(antisymmetricCoeffs.data(), numFIRCoeffs, nSamples) != 0) {
+        fprintf(stderr, "Kernel verification failed\n");
+        return -1;
+    }
+
+    // One filter instance per channel
+    std::vector<FIRFilter> filters(numChannels);
+    for (int ch = 0; ch < numChannels; ch++) {
+        if (firInit(&filters[ch], firCoeffs.data(), numFIRCoeffs) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            return -1;
+        }
+    }
+
+    printf("taps=%d chunk=%d channels=%d chunks=%d cores=%d kernel=%s\n", numFIRCoeffs, nSamples, numChannels,
+           numChunks, maxThreads, firSelectKernel(firDetectSymmetry(firCoeffs.data(), numFIRCoeffs), numFIRCoeffs).name);
+    printf("%8s %14s %14s %16s\n", "threads", "Msamples/s", "speedup", "channels/core@48k");
+
+    // Thread counts 1, 2, 4, ... and the full core count
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double singleThreadRate = 0.0;
+    for (int numThreads : threadCounts) {
+        std::vector<std::vector<float>> outputChunks(numThreads, std::vector<float>(nSamples));
+        std::vector<std::thread> workers;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < numThreads; t++) {
+            int first = (int)((long)numChannels * t / numThreads);
+            int last = (int)((long)numChannels * (t + 1) / numThreads);
+            workers.emplace_back(runChannels, filters.data(), first, last, inputChunk.data(),
+                                 outputChunks[t].data(), nSamples, numChunks);
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double rate = (double)numChannels * nSamples * numChunks / seconds;
+        if (numThreads == 1) {
+            singleThreadRate = rate;
+        }
+        printf("%8d %14.2f %14.2f %16.1f\n", numThreads, rate * 1e-6, rate / singleThreadRate,
+               rate / numThreads / 48000.0);
+    }
+
+    for (int ch = 0; ch < numChannels; ch++) {
+        firFree(&filters[ch]);
+    }
+
+    reportPartitions(firCoeffs.data(), numFIRCoeffs);
+    return 0;
+}
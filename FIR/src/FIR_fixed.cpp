@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sndfile.h>
+#include "../include/data.h"
+#include "../include/fir.h"
+#include "../include/firFixed.h"
+
+int main(int argc, char *argv[]) {
+    if (argc != 8) {
+        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <FIR coeffs file> <num FIR coeffs> <buffer size> <q15|q31> <round|truncate>\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *inputFile = argv[1];
+    char *outputFile = argv[2];
+    char *firCoeffsFile = argv[3];
+    int numFIRCoeffs = atoi(argv[4]);
+    int nSamples = atoi(argv[5]);
+    bool useQ31 = strcmp(argv[6], "q31") == 0;
+    QuantMode quantMode = strcmp(argv[7], "truncate") == 0 ? QUANT_TRUNCATE : QUANT_ROUND;
+    if ((!useQ31 && strcmp(argv[6], "q15") != 0) || (quantMode == QUANT_ROUND && strcmp(argv[7], "round") != 0)) {
+        fprintf(stderr, "Invalid format. Use 'q15' or 'q31' and 'round' or 'truncate'.\n");
+        return 1;
+    }
+    if (numFIRCoeffs <= 0 || nSamples <= 0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    float *firCoeffs = (float*)calloc(numFIRCoeffs, sizeof(float));
+    if (!firCoeffs) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return -1;
+    }
+    readFIRCoeffsFromFile(firCoeffsFile, firCoeffs, numFIRCoeffs);
+
+    SF_INFO sfinfo;
+    SNDFILE *infile = sf_open(inputFile, SFM_READ, &sfinfo);
+    if (!infile) {
+        fprintf(stderr, "Could not open input file: %s\n", inputFile);
+        free(firCoeffs);
+        return -1;
+    }
+    SNDFILE *outfile = sf_open(outputFile, SFM_WRITE, &sfinfo);
+    if (!outfile) {
+        fprintf(stderr, "Could not open output file: %s\n", outputFile);
+        sf_close(infile);
+        free(firCoeffs);
+        return -1;
+    }
+
+    // Float reference and fixed-point filter per channel
+    int numChannels = sfinfo.channels;
+    FIRFilter *reference = (FIRFilter*)calloc(numChannels, sizeof(FIRFilter));
+    FIRFilterQ15 *filtersQ15 = (FIRFilterQ15*)calloc(numChannels, sizeof(FIRFilterQ15));
+    FIRFilterQ31 *filtersQ31 = (FIRFilterQ31*)calloc(numChannels, sizeof(FIRFilterQ31));
+    float *inputChunk = (float*)malloc(nSamples * numChannels * sizeof(float));
+    float *outputChunk = (float*)malloc(nSamples * numChannels * sizeof(float));
+    float *channelInput = (float*)malloc(nSamples * sizeof(float));
+    float *channelReference = (float*)malloc(nSamples * sizeof(float));
+    int16_t *samplesQ15 = (int16_t*)malloc(2 * nSamples * sizeof(int16_t));
+    int32_t *samplesQ31 = (int32_t*)malloc(2 * nSamples * sizeof(int32_t));
+    int status = -1;
+
+    if (!reference || !filtersQ15 || !filtersQ31 || !inputChunk || !outputChunk || !channelInput ||
+        !channelReference || !samplesQ15 || !samplesQ31) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        goto done;
+    }
+    for (int ch = 0; ch < numChannels; ch++) {
+        int result = firInit(&reference[ch], firCoeffs, numFIRCoeffs);
+        result |= useQ31 ? firInitQ31(&filtersQ31[ch], firCoeffs, numFIRCoeffs, quantMode)
+                         : firInitQ15(&filtersQ15[ch], firCoeffs, numFIRCoeffs, quantMode);
+        if (result != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            goto done;
+        }
+    }
+
+    {
+        // Accumulate signal and error energy over the whole file
+        double signalEnergy = 0.0;
+        double errorEnergy = 0.0;
+        double maxError = 0.0;
+        sf_count_t num_read;
+
+        while ((num_read = sf_readf_float(infile, inputChunk, nSamples)) > 0) {
+            for (int ch = 0; ch < numChannels; ch++) {
+                for (int n = 0; n < num_read; n++) {
+                    channelInput[n] = inputChunk[n * numChannels + ch];
+                }
+                processSignal(&reference[ch], channelInput, channelReference, num_read);
+
+                // Same input, quantized to the sample format
+                for (int n = 0; n < num_read; n++) {
+                    if (useQ31) {
+                        samplesQ31[n] = floatToQ31(channelInput[n], QUANT_ROUND);
+                    } else {
+                        samplesQ15[n] = floatToQ15(channelInput[n], QUANT_ROUND);
+                    }
+                }
+                if (useQ31) {
+                    processSignalQ31(&filtersQ31[ch], samplesQ31, samplesQ31 + nSamples, num_read);
+                } else {
+                    processSignalQ15(&filtersQ15[ch], samplesQ15, samplesQ15 + nSamples, num_read);
+                }
+
+                for (int n = 0; n < num_read; n++) {
+                    float fixedOutput = useQ31 ? q31ToFloat(samplesQ31[nSamples + n]) : q15ToFloat(samplesQ15[nSamples + n]);
+                    double error = (double)fixedOutput - channelReference[n];
+                    signalEnergy += (double)channelReference[n] * channelReference[n];
+                    errorEnergy += error * error;
+                    maxError = fmax(maxError, fabs(error));
+                    outputChunk[n * numChannels + ch] = fixedOutput;
+                }
+            }
+            sf_writef_float(outfile, outputChunk, num_read);
+        }
+
+        const char *format = useQ31 ? "Q31" : "Q15";
+        int coeffShift = useQ31 ? filtersQ31[0].coeffShift : filtersQ15[0].coeffShift;
+        printf("%s, %s coefficients in Q%d\n", format, quantMode == QUANT_ROUND ? "rounded" : "truncated",
+               (useQ31 ? 31 : 15) - coeffShift);
+        printf("SNR against float reference: %.2f dB, max abs error %.3g\n",
+               errorEnergy > 0.0 ? 10.0 * log10(signalEnergy / errorEnergy) : INFINITY, maxError);
+    }
+    status = 0;
+
+done:
+    for (int ch = 0; ch < numChannels; ch++) {
+        if (reference) firFree(&reference[ch]);
+        if (filtersQ15) firFreeQ15(&filtersQ15[ch]);
+        if (filtersQ31) firFreeQ31(&filtersQ31[ch]);
+    }
+    free(reference);
+    free(filtersQ15);
+    free(filtersQ31);
+    free(inputChunk);
+    free(outputChunk);
+    free(channelInput);
+    free(channelReference);
+    free(samplesQ15);
+    free(samplesQ31);
+    free(firCoeffs);
+    sf_close(infile);
+    sf_close(outfile);
+    return status;
+}
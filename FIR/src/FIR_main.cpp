@@ -4,13 +4,160 @@
 #include <sndfile.h>
 #include "../include/data.h"
 #include "../include/fir.h"
+#include "../include/firFFT.h"
+#include "../include/firPartitioned.h"
+#include "../include/firMultichannel.h"
+#include "../include/denormal.h"
 
-void cleanup(float *coeffs, float *buffer, float *inputChunk, float *outputChunk, SNDFILE *infile, SNDFILE *outfile);
+// Convolution engines selectable on the command line
+typedef enum {
+    ENGINE_AUTO,
+    ENGINE_DIRECT,
+    ENGINE_FFT,
+    ENGINE_PARTITIONED
+} EngineType;
+
+// Direct form filters the interleaved frames with the channels in SIMD lanes.
+// The block engines are single channel, for them the chunk is split into one
+// contiguous run per channel (channel-major) and every channel has its own engine.
+typedef struct {
+    EngineType type;
+    int numChannels;
+    int maxFrames;
+    FIRFilter direct;
+    FIRMultiFilter multi;
+    FIRFFTFilter *fft;
+    FIRPartitionedFilter *partitioned;
+    float *channelInput;     // numChannels x maxFrames
+    float *channelOutput;    // numChannels x maxFrames
+    int latency;
+} Engine;
+
+int engineInit(Engine *engine, EngineType type, const float *coeffs, int numFIRCoeffs, int numChannels, int maxFrames);
+void engineProcess(Engine *engine, const float *input, float *output, int numFrames);
+void engineFree(Engine *engine);
+int engineCountSubnormals(const Engine *engine);
+void cleanup(float *coeffs, Engine *engine, float *inputChunk, float *outputChunk, SNDFILE *infile, SNDFILE *outfile);
+
+// Set up the requested engine, direct form has no latency
+int engineInit(Engine *engine, EngineType type, const float *coeffs, int numFIRCoeffs, int numChannels, int maxFrames) {
+    memset(engine, 0, sizeof(Engine));
+    engine->type = type;
+    engine->numChannels = numChannels;
+    engine->maxFrames = maxFrames;
+
+    if (type == ENGINE_DIRECT) {
+        if (numChannels == 1) {
+            return firInit(&engine->direct, coeffs, numFIRCoeffs);
+        }
+        return firMultiInit(&engine->multi, coeffs, numFIRCoeffs, numChannels);
+    }
+
+    engine->channelInput = (float*)malloc(numChannels * maxFrames * sizeof(float));
+    engine->channelOutput = (float*)malloc(numChannels * maxFrames * sizeof(float));
+    if (type == ENGINE_PARTITIONED) {
+        engine->partitioned = (FIRPartitionedFilter*)calloc(numChannels, sizeof(FIRPartitionedFilter));
+    } else {
+        engine->fft = (FIRFFTFilter*)calloc(numChannels, sizeof(FIRFFTFilter));
+    }
+    if (!engine->channelInput || !engine->channelOutput || (!engine->partitioned && !engine->fft)) {
+        return -1;
+    }
+
+    for (int ch = 0; ch < numChannels; ch++) {
+        if (type == ENGINE_PARTITIONED) {
+            if (firPartitionedInit(&engine->partitioned[ch], coeffs, numFIRCoeffs, fftNextPow2(maxFrames)) != 0) {
+                return -1;
+            }
+            engine->latency = engine->partitioned[ch].latency;
+        } else {
+            if (firFFTInit(&engine->fft[ch], coeffs, numFIRCoeffs, 0) != 0) {
+                return -1;
+            }
+            engine->latency = engine->fft[ch].latency;
+        }
+    }
+    return 0;
+}
+
+// Filter numFrames interleaved frames
+void engineProcess(Engine *engine, const float *input, float *output, int numFrames) {
+    int numChannels = engine->numChannels;
+
+    if (engine->type == ENGINE_DIRECT) {
+        if (numChannels == 1) {
+            processSignal(&engine->direct, input, output, numFrames);
+        } else {
+            processMultichannel(&engine->multi, input, output, numFrames);
+        }
+        return;
+    }
+
+    // Deinterleave into channel-major layout
+    for (int n = 0; n < numFrames; n++) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            engine->channelInput[ch * engine->maxFrames + n] = input[n * numChannels + ch];
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ch++) {
+        const float *in = engine->channelInput + ch * engine->maxFrames;
+        float *out = engine->channelOutput + ch * engine->maxFrames;
+        if (engine->type == ENGINE_PARTITIONED) {
+            firPartitionedProcess(&engine->partitioned[ch], in, out, numFrames);
+        } else {
+            firFFTProcess(&engine->fft[ch], in, out, numFrames);
+        }
+    }
+
+    // Interleave the results again
+    for (int n = 0; n < numFrames; n++) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            output[n * numChannels + ch] = engine->channelOutput[ch * engine->maxFrames + n];
+        }
+    }
+}
+
+void engineFree(Engine *engine) {
+    if (engine->type == ENGINE_DIRECT) {
+        if (engine->numChannels == 1) {
+            firFree(&engine->direct);
+        } else {
+            firMultiFree(&engine->multi);
+        }
+        return;
+    }
+
+    for (int ch = 0; ch < engine->numChannels; ch++) {
+        if (engine->partitioned) {
+            firPartitionedFree(&engine->partitioned[ch]);
+        }
+        if (engine->fft) {
+            firFFTFree(&engine->fft[ch]);
+        }
+    }
+    free(engine->partitioned);
+    free(engine->fft);
+    free(engine->channelInput);
+    free(engine->channelOutput);
+}
+
+// Subnormal samples in the direct form delay lines. The block engines keep their
+// history in the frequency domain, for them only the output is checked.
+int engineCountSubnormals(const Engine *engine) {
+    if (engine->type != ENGINE_DIRECT) {
+        return 0;
+    }
+    if (engine->numChannels == 1) {
+        return countSubnormals(engine->direct.buffer, 2 * engine->direct.numFIRCoeffs);
+    }
+    return countSubnormals(engine->multi.buffer, 2 * engine->multi.numFIRCoeffs * engine->multi.numLanes);
+}
 
 // Cleanup 
-void cleanup(float *coeffs, float *buffer, float *inputChunk, float *outputChunk, SNDFILE *infile, SNDFILE *outfile) {
+void cleanup(float *coeffs, Engine *engine, float *inputChunk, float *outputChunk, SNDFILE *infile, SNDFILE *outfile) {
     free(coeffs);
-    free(buffer);
+    if (engine) engineFree(engine);
     free(inputChunk);
     free(outputChunk);
     sf_close(infile);
@@ -18,8 +165,8 @@ void cleanup(float *coeffs, float *buffer, float *inputChunk, float *outputChunk
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 6) {
-        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <FIR coeffs file> <num FIR coeffs> <buffer size>\n", argv[0]);
+    if (argc < 6 || argc > 9) {
+        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <FIR coeffs file> <num FIR coeffs> <buffer size> [direct|fft|partitioned|auto] [ftz] [count]\n", argv[0]);
         return 1;
     }
 
@@ -29,39 +176,89 @@ int main(int argc, char *argv[]) {
     char *firCoeffsFile = argv[3];
     int numFIRCoeffs = atoi(argv[4]);
     int nSamples = atoi(argv[5]);
+    EngineType engineType = ENGINE_AUTO;
+    bool flushToZero = false;
+    bool countDenormals = false;
+    for (int i = 6; i < argc; i++) {
+        if (strcmp(argv[i], "direct") == 0) {
+            engineType = ENGINE_DIRECT;
+        } else if (strcmp(argv[i], "fft") == 0) {
+            engineType = ENGINE_FFT;
+        } else if (strcmp(argv[i], "partitioned") == 0) {
+            engineType = ENGINE_PARTITIONED;
+        } else if (strcmp(argv[i], "ftz") == 0) {
+            flushToZero = true;
+        } else if (strcmp(argv[i], "count") == 0) {
+            countDenormals = true;
+        } else if (strcmp(argv[i], "auto") != 0) {
+            fprintf(stderr, "Invalid mode. Use 'direct', 'fft', 'partitioned' or 'auto', then 'ftz' and 'count'.\n");
+            return 1;
+        }
+    }
+
+    // Before any filter runs, so the threshold measurement sees the same mode
+    if (flushToZero && !enableFlushToZero()) {
+        fprintf(stderr, "Flush-to-zero is not supported on this target, continuing without it\n");
+    }
+
+    // Switch to overlap-save above the tap count where it is faster on this machine.
+    // Plain overlap-save lags by more than the filter length, so filters longer than
+    // the buffer use the partitioned engine to keep the latency at one buffer.
+    if (engineType == ENGINE_AUTO) {
+        int threshold = firFFTThreshold(numFIRCoeffs);
+        if (numFIRCoeffs < threshold) {
+            engineType = ENGINE_DIRECT;
+        } else if (numFIRCoeffs >= nSamples) {
+            engineType = ENGINE_PARTITIONED;
+        } else {
+            engineType = ENGINE_FFT;
+        }
+        printf("Measured overlap-save threshold: %d taps, using %s convolution\n", threshold,
+               engineType == ENGINE_DIRECT ? "direct" : (engineType == ENGINE_FFT ? "FFT" : "partitioned"));
+    }
 
     // Initialize data arrays
-    int bufferSize = nSamples+numFIRCoeffs-1;
     float *firCoeffs = (float*)malloc(numFIRCoeffs*sizeof(float));
-    float *buffer = (float*)malloc(bufferSize*sizeof(float));
-    float *inputChunk = (float*)malloc(nSamples*sizeof(float));
-    float *outputChunk = (float*)malloc(nSamples*sizeof(float));
+    Engine engine;
+    float *inputChunk = NULL;
+    float *outputChunk = NULL;
     SNDFILE *infile = NULL; 
     SNDFILE *outfile = NULL;
     SF_INFO sfinfo;
     sf_count_t num_read;
 
     // Check memory allocation
-    if (!firCoeffs || !buffer || !inputChunk || !outputChunk) {
+    if (!firCoeffs) {
         fprintf(stderr, "Failed to allocate memory\n");
-        cleanup(firCoeffs, buffer, inputChunk, outputChunk, NULL, NULL);
         return -1;
     }
 
-    // Initialize buffer to zero
-    memset(buffer, 0, bufferSize * sizeof(float));
-    memset(firCoeffs, 0, numFIRCoeffs * sizeof(float));
-    memset(inputChunk, 0, nSamples * sizeof(float));
-    memset(outputChunk, 0, nSamples * sizeof(float));
-
     // Read FIR filter coefficients
+    memset(firCoeffs, 0, numFIRCoeffs * sizeof(float));
     readFIRCoeffsFromFile(firCoeffsFile, firCoeffs, numFIRCoeffs);
     
     // Input WAV file pointer
     infile = sf_open(inputFile, SFM_READ, &sfinfo);
     if (!infile) {
         fprintf(stderr, "Could not open input file: %s\n", inputFile);
-        cleanup(firCoeffs, buffer, inputChunk, outputChunk, infile, NULL);  
+        cleanup(firCoeffs, NULL, inputChunk, outputChunk, infile, NULL);  
+        return -1;
+    }
+
+    // Chunks hold nSamples interleaved frames of all channels
+    int numChannels = sfinfo.channels;
+    inputChunk = (float*)calloc(nSamples * numChannels, sizeof(float));
+    outputChunk = (float*)calloc(nSamples * numChannels, sizeof(float));
+    if (!inputChunk || !outputChunk) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(firCoeffs, NULL, inputChunk, outputChunk, infile, NULL);
+        return -1;
+    }
+
+    // One delay line per channel, the FFT engines transform the coefficients once here
+    if (engineInit(&engine, engineType, firCoeffs, numFIRCoeffs, numChannels, nSamples) != 0) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(firCoeffs, &engine, inputChunk, outputChunk, infile, NULL);
         return -1;
     }
 
@@ -69,19 +266,49 @@ int main(int argc, char *argv[]) {
     outfile = sf_open(outputFile, SFM_WRITE, &sfinfo);
     if (!outfile) {
         fprintf(stderr, "Could not open output file: %s\n", outputFile);
-        cleanup(firCoeffs, buffer, inputChunk, outputChunk, infile, outfile); 
+        cleanup(firCoeffs, &engine, inputChunk, outputChunk, infile, outfile); 
         return -1;
     }
 
     // Process audio file in chunks
-    // num_read is always <= nSamples
-    while ((num_read = sf_read_float(infile, inputChunk, nSamples)) > 0) {
-        processSignal( inputChunk, outputChunk, firCoeffs, buffer,
-        num_read,numFIRCoeffs, bufferSize);
-        sf_write_float(outfile, outputChunk, num_read);
+    // num_read is always <= nSamples frames
+    // Block engines lag by engine.latency frames, these are dropped at the start
+    // and flushed with zeros at the end so the output lines up with the input
+    int toSkip = engine.latency;
+    int chunkIndex = 0;
+    long totalOutput = 0;
+    long totalDelayLine = 0;
+    while ((num_read = sf_readf_float(infile, inputChunk, nSamples)) > 0) {
+        engineProcess(&engine, inputChunk, outputChunk, num_read);
+        if (countDenormals) {
+            int output = countSubnormals(outputChunk, num_read * numChannels);
+            int delayLine = engineCountSubnormals(&engine);
+            if (output > 0 || delayLine > 0) {
+                printf("chunk %d: %d subnormal outputs, %d subnormal delay line samples\n", chunkIndex, output, delayLine);
+            }
+            totalOutput += output;
+            totalDelayLine += delayLine;
+        }
+        chunkIndex++;
+        int skip = toSkip < num_read ? toSkip : (int)num_read;
+        toSkip -= skip;
+        sf_writef_float(outfile, outputChunk + skip * numChannels, num_read - skip);
+    }
+
+    memset(inputChunk, 0, nSamples * numChannels * sizeof(float));
+    for (int remaining = engine.latency; remaining > 0; remaining -= nSamples) {
+        int count = remaining < nSamples ? remaining : nSamples;
+        engineProcess(&engine, inputChunk, outputChunk, count);
+        int skip = toSkip < count ? toSkip : count;
+        toSkip -= skip;
+        sf_writef_float(outfile, outputChunk + skip * numChannels, count - skip);
+    }
+
+    if (countDenormals) {
+        printf("%d chunks: %ld subnormal outputs, %ld subnormal delay line samples\n", chunkIndex, totalOutput, totalDelayLine);
     }
 
     // Free memory
-    cleanup(firCoeffs, buffer, inputChunk, outputChunk, infile, outfile);
+    cleanup(firCoeffs, &engine, inputChunk, outputChunk, infile, outfile);
     return 0;
 }
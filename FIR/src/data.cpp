@@ -20,3 +20,21 @@ void readFIRCoeffsFromFile(const char *fileName, float *coeffs, size_t numFIRCoe
 
     fclose(fp);
 }
+
+// Count the values of a coefficient file
+int countFIRCoeffsInFile(const char *fileName) {
+    FILE *fp = fopen(fileName, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error opening file %s for reading.\n", fileName);
+        return -1;
+    }
+
+    int count = 0;
+    float value;
+    while (fscanf(fp, "%f\n", &value) == 1) {
+        count++;
+    }
+
+    fclose(fp);
+    return count;
+}
@@ -0,0 +1,27 @@
+#include <stdint.h>
+#include <string.h>
+#include "../include/denormal.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+bool enableFlushToZero(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    // FTZ is bit 15, DAZ is bit 6
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Exponent bits all zero, mantissa not zero
+int countSubnormals(const float *data, int n) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        count += ((bits & 0x7F800000u) == 0 && (bits & 0x007FFFFFu) != 0) ? 1 : 0;
+    }
+    return count;
+}
@@ -1,29 +1,54 @@
+#include <stdlib.h>
 #include "../include/fir.h"
 
-// Circular buffer FIR Filtering
-void processSignal(float *inputDataChunk, float *outputDataChunk, float *firCoeffs, float *buffer,
-                   int numSamples, int numFIRCoeffs, int bufferSize) {
-    static int bufferIndex = 0;  
+// Bind coefficients and allocate the delay line
+int firInit(FIRFilter *filter, const float *firCoeffs, int numFIRCoeffs) {
+    filter->firCoeffs = firCoeffs;
+    filter->numFIRCoeffs = numFIRCoeffs;
+    filter->bufferIndex = 0;
+    filter->dot = firSelectKernel(firDetectSymmetry(firCoeffs, numFIRCoeffs), numFIRCoeffs).dot;
+    filter->buffer = (float*)malloc(2 * numFIRCoeffs * sizeof(float));
+    if (!filter->buffer) {
+        return -1;
+    }
 
-    // Process each sample in the input chunk
-    for (int n = 0; n < numSamples; n++) {
-        // Insert new sample in circular buffer
-        buffer[bufferIndex] = inputDataChunk[n];
+    memset(filter->buffer, 0, 2 * numFIRCoeffs * sizeof(float));
+    return 0;
+}
 
-        // FIR filter cummulator
-        float accum = 0.0;
-        int index = bufferIndex;
+// Clear the delay line
+void firReset(FIRFilter *filter) {
+    memset(filter->buffer, 0, 2 * filter->numFIRCoeffs * sizeof(float));
+    filter->bufferIndex = 0;
+}
 
-        // Convolution sum
-        // we go back in the buffer and increment the coefficients
-        for (int k = 0; k < numFIRCoeffs; k++) {
-            accum += firCoeffs[k] * buffer[index];
-            index = (index - 1 + bufferSize) % bufferSize;  
-        }
+// Free the delay line
+void firFree(FIRFilter *filter) {
+    free(filter->buffer);
+    filter->buffer = NULL;
+}
 
-        outputDataChunk[n] = accum;
+// Mirrored buffer FIR Filtering
+void processSignal(FIRFilter *filter, const float *inputDataChunk, float *outputDataChunk, int numSamples) {
+    const float *firCoeffs = filter->firCoeffs;
+    float *buffer = filter->buffer;
+    int numFIRCoeffs = filter->numFIRCoeffs;
+    int bufferIndex = filter->bufferIndex;
+    FIRDotKernel dot = filter->dot;
 
-        // Move the buffer index 
-        bufferIndex = (bufferIndex + 1) % bufferSize;
+    // Process each sample in the input chunk
+    for (int n = 0; n < numSamples; n++) {
+        // Step back one position, the new sample is the first one of the window
+        bufferIndex = (bufferIndex == 0) ? numFIRCoeffs - 1 : bufferIndex - 1;
+
+        // Insert new sample in both halves of the buffer
+        buffer[bufferIndex] = inputDataChunk[n];
+        buffer[bufferIndex + numFIRCoeffs] = inputDataChunk[n];
+
+        // Convolution sum over the contiguous window
+        outputDataChunk[n] = dot(firCoeffs, buffer + bufferIndex, numFIRCoeffs);
     }
+
+    // Keep the write position for the next chunk
+    filter->bufferIndex = bufferIndex;
 }
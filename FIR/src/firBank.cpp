@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/firBank.h"
+
+// Outputs per tile, small enough that the window stays in L1
+#define BANK_TILE 64
+
+int firBankInit(FIRBank *bank, const float *const *firCoeffs, const int *numFIRCoeffs, int numBands, int maxBlock) {
+    if (numBands <= 0 || maxBlock <= 0) {
+        return -1;
+    }
+
+    int longest = 1;
+    for (int b = 0; b < numBands; b++) {
+        if (numFIRCoeffs[b] > longest) {
+            longest = numFIRCoeffs[b];
+        }
+    }
+
+    bank->numBands = numBands;
+    bank->numFIRCoeffs = longest;
+    bank->maxBlock = maxBlock;
+    bank->bankCoeffs = (float*)calloc(numBands * longest, sizeof(float));
+    bank->bandOffsets = (int*)malloc(numBands * sizeof(int));
+    bank->dots = (FIRDotKernel*)malloc(numBands * sizeof(FIRDotKernel));
+    bank->buffer = (float*)calloc(longest - 1 + maxBlock, sizeof(float));
+    if (!bank->bankCoeffs || !bank->bandOffsets || !bank->dots || !bank->buffer) {
+        firBankFree(bank);
+        return -1;
+    }
+
+    // Row b holds h_b reversed, right aligned so shorter filters see the newest samples
+    for (int b = 0; b < numBands; b++) {
+        float *row = bank->bankCoeffs + b * longest;
+        for (int k = 0; k < numFIRCoeffs[b]; k++) {
+            row[longest - 1 - k] = firCoeffs[b][k];
+        }
+        bank->bandOffsets[b] = longest - numFIRCoeffs[b];
+        bank->dots[b] = firSelectKernel(FIR_ASYMMETRIC, numFIRCoeffs[b]).dot;
+    }
+    return 0;
+}
+
+void firBankFree(FIRBank *bank) {
+    free(bank->bankCoeffs);
+    free(bank->bandOffsets);
+    free(bank->dots);
+    free(bank->buffer);
+    bank->bankCoeffs = NULL;
+    bank->bandOffsets = NULL;
+    bank->dots = NULL;
+    bank->buffer = NULL;
+}
+
+void processBank(FIRBank *bank, const float *input, float *const *outputs, int nSamples) {
+    int numFIRCoeffs = bank->numFIRCoeffs;
+    int history = numFIRCoeffs - 1;
+
+    // Append the block behind the history
+    memcpy(bank->buffer + history, input, nSamples * sizeof(float));
+
+    // y_b[n] = sum_j row_b[j] * buffer[n + j], from the first nonzero tap of the row
+    for (int start = 0; start < nSamples; start += BANK_TILE) {
+        int end = (start + BANK_TILE < nSamples) ? start + BANK_TILE : nSamples;
+        for (int b = 0; b < bank->numBands; b++) {
+            int offset = bank->bandOffsets[b];
+            const float *row = bank->bankCoeffs + b * numFIRCoeffs + offset;
+            const float *window = bank->buffer + offset;
+            FIRDotKernel dot = bank->dots[b];
+            float *out = outputs[b];
+            for (int n = start; n < end; n++) {
+                out[n] = dot(row, window + n, numFIRCoeffs - offset);
+            }
+        }
+    }
+
+    // Keep the newest numFIRCoeffs-1 samples for the next block
+    memmove(bank->buffer, bank->buffer + nSamples, history * sizeof(float));
+}
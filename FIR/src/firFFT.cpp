@@ -0,0 +1,202 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "../include/fir.h"
+#include "../include/firFFT.h"
+
+// Cost per output sample ~ (N log2 N) / (N - M + 1), try a few sizes above 2M
+// (the real FFT needs at least 4 points, which a 1-tap filter would go below)
+static int chooseFFTSize(int numFIRCoeffs) {
+    int best = 0;
+    double bestCost = 0.0;
+    int smallest = fftNextPow2(2 * numFIRCoeffs);
+    if (smallest < 4) {
+        smallest = 4;
+    }
+    for (int size = smallest; size <= 16 * fftNextPow2(numFIRCoeffs) && size > 0; size *= 2) {
+        double cost = size * log2((double)size) / (size - numFIRCoeffs + 1);
+        if (best == 0 || cost < bestCost) {
+            best = size;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+int firFFTInit(FIRFFTFilter *filter, const float *firCoeffs, int numFIRCoeffs, int fftSize) {
+    memset(filter, 0, sizeof(FIRFFTFilter));
+    if (fftSize == 0) {
+        fftSize = chooseFFTSize(numFIRCoeffs);
+    }
+    if (fftSize < numFIRCoeffs || fftInit(&filter->plan, fftSize) != 0) {
+        return -1;
+    }
+
+    filter->numFIRCoeffs = numFIRCoeffs;
+    filter->fftSize = fftSize;
+    filter->blockSize = fftSize - numFIRCoeffs + 1;
+    filter->latency = filter->blockSize;
+    filter->coeffSpectrum = (Complex*)malloc((fftSize / 2 + 1) * sizeof(Complex));
+    filter->spectrum = (Complex*)malloc((fftSize / 2 + 1) * sizeof(Complex));
+    filter->timeBuffer = (float*)calloc(fftSize, sizeof(float));
+    filter->outputBlock = (float*)calloc(fftSize, sizeof(float));
+    if (!filter->coeffSpectrum || !filter->spectrum || !filter->timeBuffer || !filter->outputBlock) {
+        firFFTFree(filter);
+        return -1;
+    }
+
+    // Zero padded coefficients, transformed once
+    memcpy(filter->timeBuffer, firCoeffs, numFIRCoeffs * sizeof(float));
+    fftRealForward(&filter->plan, filter->timeBuffer, filter->coeffSpectrum);
+    memset(filter->timeBuffer, 0, fftSize * sizeof(float));
+    return 0;
+}
+
+void firFFTFree(FIRFFTFilter *filter) {
+    fftFree(&filter->plan);
+    free(filter->coeffSpectrum);
+    free(filter->spectrum);
+    free(filter->timeBuffer);
+    free(filter->outputBlock);
+    filter->coeffSpectrum = NULL;
+    filter->spectrum = NULL;
+    filter->timeBuffer = NULL;
+    filter->outputBlock = NULL;
+}
+
+// Circular convolution of the time buffer, the first numFIRCoeffs-1 results are aliased and dropped
+static void processBlock(FIRFFTFilter *filter) {
+    int half = filter->fftSize / 2;
+    int history = filter->numFIRCoeffs - 1;
+
+    fftRealForward(&filter->plan, filter->timeBuffer, filter->spectrum);
+    for (int k = 0; k <= half; k++) {
+        Complex x = filter->spectrum[k];
+        Complex h = filter->coeffSpectrum[k];
+        filter->spectrum[k].real = x.real * h.real - x.imag * h.imag;
+        filter->spectrum[k].imag = x.real * h.imag + x.imag * h.real;
+    }
+    fftRealInverse(&filter->plan, filter->spectrum, filter->outputBlock);
+    memmove(filter->outputBlock, filter->outputBlock + history, filter->blockSize * sizeof(float));
+
+    // Keep the last numFIRCoeffs-1 inputs as history for the next block
+    memmove(filter->timeBuffer, filter->timeBuffer + filter->blockSize, history * sizeof(float));
+}
+
+void firFFTProcess(FIRFFTFilter *filter, const float *input, float *output, int nSamples) {
+    int history = filter->numFIRCoeffs - 1;
+    int n = 0;
+
+    while (n < nSamples) {
+        // Copy as much as fits into the current block
+        int count = filter->blockSize - filter->blockIndex;
+        if (count > nSamples - n) {
+            count = nSamples - n;
+        }
+        memcpy(filter->timeBuffer + history + filter->blockIndex, input + n, count * sizeof(float));
+        memcpy(output + n, filter->outputBlock + filter->blockIndex, count * sizeof(float));
+        filter->blockIndex += count;
+        n += count;
+
+        if (filter->blockIndex == filter->blockSize) {
+            processBlock(filter);
+            filter->blockIndex = 0;
+        }
+    }
+}
+
+// Seconds to filter nSamples of noise
+static double timeDirect(const float *firCoeffs, int numFIRCoeffs, const float *input, float *output, int nSamples) {
+    FIRFilter filter;
+    if (firInit(&filter, firCoeffs, numFIRCoeffs) != 0) {
+        return 0.0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    processSignal(&filter, input, output, nSamples);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    firFree(&filter);
+    return seconds;
+}
+
+static double timeFFT(const float *firCoeffs, int numFIRCoeffs, const float *input, float *output, int nSamples) {
+    FIRFFTFilter filter;
+    if (firFFTInit(&filter, firCoeffs, numFIRCoeffs, 0) != 0) {
+        return 1e30;
+    }
+    auto start = std::chrono::steady_clock::now();
+    firFFTProcess(&filter, input, output, nSamples);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    firFFTFree(&filter);
+    return seconds;
+}
+
+// Best of three runs to keep scheduler noise out of the decision
+static bool fftFaster(const float *firCoeffs, int taps, const float *input, float *output) {
+    int length = 8 * chooseFFTSize(taps);
+    if (length < 8192) {
+        length = 8192;
+    }
+    double direct = 1e30;
+    double fft = 1e30;
+    for (int run = 0; run < 3; run++) {
+        direct = fmin(direct, timeDirect(firCoeffs, taps, input, output, length));
+        fft = fmin(fft, timeFFT(firCoeffs, taps, input, output, length));
+    }
+    return fft < direct;
+}
+
+int firFFTThreshold(int maxTaps) {
+    // Several overlap-save blocks for the largest filter
+    int nSamples = 8 * chooseFFTSize(maxTaps);
+    if (nSamples < 8192) {
+        nSamples = 8192;
+    }
+    float *firCoeffs = (float*)malloc(maxTaps * sizeof(float));
+    float *input = (float*)malloc(nSamples * sizeof(float));
+    float *output = (float*)malloc(nSamples * sizeof(float));
+    int threshold = maxTaps + 1;
+    if (!firCoeffs || !input || !output) {
+        free(firCoeffs);
+        free(input);
+        free(output);
+        return threshold;
+    }
+
+    for (int k = 0; k < maxTaps; k++) {
+        firCoeffs[k] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    for (int n = 0; n < nSamples; n++) {
+        input[n] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    // Sweep powers of two upwards (and maxTaps itself) to the first tap count where
+    // overlap-save wins, then bisect between it and the last one where it lost
+    int lower = 0;
+    for (int taps = 16; lower < maxTaps; taps *= 2) {
+        if (taps > maxTaps) {
+            taps = maxTaps;
+        }
+        if (fftFaster(firCoeffs, taps, input, output)) {
+            threshold = taps;
+            break;
+        }
+        lower = taps;
+    }
+
+    // Down to 1/16 of the bracket, finer steps are below the timing noise
+    int resolution = (lower / 16 > 1) ? lower / 16 : 1;
+    while (threshold <= maxTaps && threshold - lower > resolution) {
+        int middle = lower + (threshold - lower) / 2;
+        if (fftFaster(firCoeffs, middle, input, output)) {
+            threshold = middle;
+        } else {
+            lower = middle;
+        }
+    }
+
+    free(firCoeffs);
+    free(input);
+    free(output);
+    return threshold;
+}
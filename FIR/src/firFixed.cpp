@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/firFixed.h"
+
+// Scale, quantize and clamp to [minValue, maxValue]
+static int64_t quantize(double value, int fracBits, QuantMode mode, int64_t minValue, int64_t maxValue) {
+    double scaled = ldexp(value, fracBits);
+    scaled = (mode == QUANT_ROUND) ? floor(scaled + 0.5) : floor(scaled);
+    if (scaled > (double)maxValue) {
+        return maxValue;
+    }
+    if (scaled < (double)minValue) {
+        return minValue;
+    }
+    return (int64_t)scaled;
+}
+
+int16_t floatToQ15(float value, QuantMode mode) {
+    return (int16_t)quantize(value, 15, mode, INT16_MIN, INT16_MAX);
+}
+
+int32_t floatToQ31(float value, QuantMode mode) {
+    return (int32_t)quantize(value, 31, mode, INT32_MIN, INT32_MAX);
+}
+
+float q15ToFloat(int16_t value) {
+    return value * (1.0f / 32768.0f);
+}
+
+float q31ToFloat(int32_t value) {
+    return (float)(value * (1.0 / 2147483648.0));
+}
+
+// Integer bits needed so the largest coefficient magnitude is below 2^shift
+static int coeffHeadroom(const float *firCoeffs, int numFIRCoeffs) {
+    float maxCoeff = 0.0f;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        maxCoeff = fmaxf(maxCoeff, fabsf(firCoeffs[k]));
+    }
+    int shift = 0;
+    while (shift < 8 && maxCoeff >= ldexpf(1.0f, shift)) {
+        shift++;
+    }
+    return shift;
+}
+
+// Saturating 64-bit add
+static inline int64_t addSaturate(int64_t a, int64_t b) {
+    int64_t sum;
+    if (__builtin_add_overflow(a, b, &sum)) {
+        return (b > 0) ? INT64_MAX : INT64_MIN;
+    }
+    return sum;
+}
+
+// Round away the fractional bits and clamp to the sample range
+static inline int64_t roundShiftSaturate(int64_t accum, int shift, int64_t minValue, int64_t maxValue) {
+    if (shift > 0) {
+        accum = addSaturate(accum, (int64_t)1 << (shift - 1)) >> shift;
+    }
+    if (accum > maxValue) {
+        return maxValue;
+    }
+    if (accum < minValue) {
+        return minValue;
+    }
+    return accum;
+}
+
+int firInitQ15(FIRFilterQ15 *filter, const float *firCoeffs, int numFIRCoeffs, QuantMode mode) {
+    filter->numFIRCoeffs = numFIRCoeffs;
+    filter->coeffShift = coeffHeadroom(firCoeffs, numFIRCoeffs);
+    filter->bufferIndex = 0;
+    filter->firCoeffs = (int16_t*)malloc(numFIRCoeffs * sizeof(int16_t));
+    filter->buffer = (int16_t*)calloc(2 * numFIRCoeffs, sizeof(int16_t));
+    if (!filter->firCoeffs || !filter->buffer) {
+        firFreeQ15(filter);
+        return -1;
+    }
+
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        filter->firCoeffs[k] = (int16_t)quantize(firCoeffs[k], 15 - filter->coeffShift, mode, INT16_MIN, INT16_MAX);
+    }
+    return 0;
+}
+
+int firInitQ31(FIRFilterQ31 *filter, const float *firCoeffs, int numFIRCoeffs, QuantMode mode) {
+    filter->numFIRCoeffs = numFIRCoeffs;
+    filter->coeffShift = coeffHeadroom(firCoeffs, numFIRCoeffs);
+    filter->bufferIndex = 0;
+    filter->firCoeffs = (int32_t*)malloc(numFIRCoeffs * sizeof(int32_t));
+    filter->buffer = (int32_t*)calloc(2 * numFIRCoeffs, sizeof(int32_t));
+    if (!filter->firCoeffs || !filter->buffer) {
+        firFreeQ31(filter);
+        return -1;
+    }
+
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        filter->firCoeffs[k] = (int32_t)quantize(firCoeffs[k], 31 - filter->coeffShift, mode, INT32_MIN, INT32_MAX);
+    }
+    return 0;
+}
+
+void firFreeQ15(FIRFilterQ15 *filter) {
+    free(filter->firCoeffs);
+    free(filter->buffer);
+    filter->firCoeffs = NULL;
+    filter->buffer = NULL;
+}
+
+void firFreeQ31(FIRFilterQ31 *filter) {
+    free(filter->firCoeffs);
+    free(filter->buffer);
+    filter->firCoeffs = NULL;
+    filter->buffer = NULL;
+}
+
+// Q15 x Q(15-s) products are Q(30-s). A sum of 32-bit products can't overflow
+// 64 bits for any realistic tap count, the saturating add only guards the limit.
+void processSignalQ15(FIRFilterQ15 *filter, const int16_t *input, int16_t *output, int nSamples) {
+    const int16_t *firCoeffs = filter->firCoeffs;
+    int16_t *buffer = filter->buffer;
+    int numFIRCoeffs = filter->numFIRCoeffs;
+    int bufferIndex = filter->bufferIndex;
+    int shift = 15 - filter->coeffShift;
+
+    for (int n = 0; n < nSamples; n++) {
+        bufferIndex = (bufferIndex == 0) ? numFIRCoeffs - 1 : bufferIndex - 1;
+        buffer[bufferIndex] = input[n];
+        buffer[bufferIndex + numFIRCoeffs] = input[n];
+
+        const int16_t *window = buffer + bufferIndex;
+        int64_t accum = 0;
+        for (int k = 0; k < numFIRCoeffs; k++) {
+            accum = addSaturate(accum, (int32_t)firCoeffs[k] * window[k]);
+        }
+        output[n] = (int16_t)roundShiftSaturate(accum, shift, INT16_MIN, INT16_MAX);
+    }
+
+    filter->bufferIndex = bufferIndex;
+}
+
+// Q31 x Q(31-s) products are Q(62-s) and would overflow after two terms, so each
+// product drops 16 fractional bits first (rounded). That leaves 16 bits of headroom.
+void processSignalQ31(FIRFilterQ31 *filter, const int32_t *input, int32_t *output, int nSamples) {
+    const int32_t *firCoeffs = filter->firCoeffs;
+    int32_t *buffer = filter->buffer;
+    int numFIRCoeffs = filter->numFIRCoeffs;
+    int bufferIndex = filter->bufferIndex;
+    int shift = 31 - filter->coeffShift - 16;
+
+    for (int n = 0; n < nSamples; n++) {
+        bufferIndex = (bufferIndex == 0) ? numFIRCoeffs - 1 : bufferIndex - 1;
+        buffer[bufferIndex] = input[n];
+        buffer[bufferIndex + numFIRCoeffs] = input[n];
+
+        const int32_t *window = buffer + bufferIndex;
+        int64_t accum = 0;
+        for (int k = 0; k < numFIRCoeffs; k++) {
+            int64_t product = ((int64_t)firCoeffs[k] * window[k] + (1 << 15)) >> 16;
+            accum = addSaturate(accum, product);
+        }
+        output[n] = (int32_t)roundShiftSaturate(accum, shift, INT32_MIN, INT32_MAX);
+    }
+
+    filter->bufferIndex = bufferIndex;
+}
@@ -0,0 +1,143 @@
+#include "../include/firKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Kernels with the tap count as template parameter. All loop bounds are compile
+// time constants, so the loops unroll completely and the accumulators stay in
+// registers. Instantiated for the tap counts in firFixedTapCounts below.
+
+template <int N>
+static float dotFixedScalar(const float *firCoeffs, const float *samples, int) {
+    float accum = 0.0f;
+#pragma GCC unroll 64
+    for (int k = 0; k < N; k++) {
+        accum += firCoeffs[k] * samples[k];
+    }
+    return accum;
+}
+
+template <int N, int Sign>
+static float dotFoldedFixedScalar(const float *firCoeffs, const float *samples, int) {
+    float accum = 0.0f;
+#pragma GCC unroll 64
+    for (int k = 0; k < N / 2; k++) {
+        accum += firCoeffs[k] * (samples[k] + Sign * samples[N - 1 - k]);
+    }
+    if (N & 1) {
+        accum += firCoeffs[N / 2] * samples[N / 2];
+    }
+    return accum;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2,fma")))
+static inline float reduceAVX2(__m256 acc) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+// Four independent accumulators hide the FMA latency
+template <int N>
+__attribute__((target("avx2,fma")))
+static float dotFixedAVX2(const float *firCoeffs, const float *samples, int) {
+    constexpr int numVectors = N / 8;
+    __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+#pragma GCC unroll 32
+    for (int v = 0; v < numVectors; v++) {
+        acc[v & 3] = _mm256_fmadd_ps(_mm256_loadu_ps(firCoeffs + 8 * v), _mm256_loadu_ps(samples + 8 * v), acc[v & 3]);
+    }
+
+    float accum = reduceAVX2(_mm256_add_ps(_mm256_add_ps(acc[0], acc[1]), _mm256_add_ps(acc[2], acc[3])));
+#pragma GCC unroll 8
+    for (int k = 8 * numVectors; k < N; k++) {
+        accum += firCoeffs[k] * samples[k];
+    }
+    return accum;
+}
+
+template <int N, int Sign>
+__attribute__((target("avx2,fma")))
+static float dotFoldedFixedAVX2(const float *firCoeffs, const float *samples, int) {
+    constexpr int half = N / 2;
+    constexpr int numVectors = half / 8;
+    const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 signs = _mm256_set1_ps((float)Sign);
+    __m256 acc[2] = {_mm256_setzero_ps(), _mm256_setzero_ps()};
+#pragma GCC unroll 16
+    for (int v = 0; v < numVectors; v++) {
+        __m256 head = _mm256_loadu_ps(samples + 8 * v);
+        __m256 tail = _mm256_permutevar8x32_ps(_mm256_loadu_ps(samples + N - 8 - 8 * v), reverse);
+        acc[v & 1] = _mm256_fmadd_ps(_mm256_loadu_ps(firCoeffs + 8 * v), _mm256_fmadd_ps(signs, tail, head), acc[v & 1]);
+    }
+
+    float accum = reduceAVX2(_mm256_add_ps(acc[0], acc[1]));
+#pragma GCC unroll 8
+    for (int k = 8 * numVectors; k < half; k++) {
+        accum += firCoeffs[k] * (samples[k] + Sign * samples[N - 1 - k]);
+    }
+    if (N & 1) {
+        accum += firCoeffs[half] * samples[half];
+    }
+    return accum;
+}
+
+#endif
+
+typedef struct {
+    int numFIRCoeffs;
+    FIRKernelInfo general;
+    FIRKernelInfo symmetric;
+    FIRKernelInfo antisymmetric;
+} FixedKernelSet;
+
+#define FIXED_KERNEL_SET(N, isa, suffix) \
+    {N, {#isa "-" #N, dotFixed##suffix<N>}, {#isa "-sym-" #N, dotFoldedFixed##suffix<N, 1>}, \
+     {#isa "-antisym-" #N, dotFoldedFixed##suffix<N, -1>}}
+
+#if defined(__x86_64__) || defined(__i386__)
+static const FixedKernelSet fixedKernelsAVX2[] = {
+    FIXED_KERNEL_SET(15, avx2, AVX2),
+    FIXED_KERNEL_SET(31, avx2, AVX2),
+    FIXED_KERNEL_SET(63, avx2, AVX2),
+    FIXED_KERNEL_SET(127, avx2, AVX2),
+    FIXED_KERNEL_SET(255, avx2, AVX2),
+};
+#endif
+
+static const FixedKernelSet fixedKernelsScalar[] = {
+    FIXED_KERNEL_SET(15, scalar, Scalar),
+    FIXED_KERNEL_SET(31, scalar, Scalar),
+    FIXED_KERNEL_SET(63, scalar, Scalar),
+    FIXED_KERNEL_SET(127, scalar, Scalar),
+    FIXED_KERNEL_SET(255, scalar, Scalar),
+};
+
+static bool lookupFixed(const FixedKernelSet *sets, int numSets, FIRSymmetry symmetry, int numFIRCoeffs,
+                        FIRKernelInfo *kernel) {
+    for (int i = 0; i < numSets; i++) {
+        if (sets[i].numFIRCoeffs == numFIRCoeffs) {
+            *kernel = (symmetry == FIR_SYMMETRIC) ? sets[i].symmetric
+                    : (symmetry == FIR_ANTISYMMETRIC) ? sets[i].antisymmetric : sets[i].general;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Specialization for the host CPU, false if the tap count has none
+bool firFixedKernel(FIRSymmetry symmetry, int numFIRCoeffs, FIRKernelInfo *kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return lookupFixed(fixedKernelsAVX2, sizeof(fixedKernelsAVX2) / sizeof(fixedKernelsAVX2[0]),
+                           symmetry, numFIRCoeffs, kernel);
+    }
+#endif
+    return lookupFixed(fixedKernelsScalar, sizeof(fixedKernelsScalar) / sizeof(fixedKernelsScalar[0]),
+                       symmetry, numFIRCoeffs, kernel);
+}
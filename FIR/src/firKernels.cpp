@@ -0,0 +1,231 @@
+#include "../include/firKernels.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+FIRSymmetry firDetectSymmetry(const float *firCoeffs, int numFIRCoeffs) {
+    float maxCoeff = 0.0f;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        maxCoeff = fmaxf(maxCoeff, fabsf(firCoeffs[k]));
+    }
+    float tolerance = 1e-6f * maxCoeff;
+
+    bool symmetric = true;
+    bool antisymmetric = true;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        float mirrored = firCoeffs[numFIRCoeffs - 1 - k];
+        symmetric = symmetric && fabsf(firCoeffs[k] - mirrored) <= tolerance;
+        antisymmetric = antisymmetric && fabsf(firCoeffs[k] + mirrored) <= tolerance;
+    }
+
+    // An all-zero filter is both, treat it as symmetric
+    if (symmetric) {
+        return FIR_SYMMETRIC;
+    }
+    return antisymmetric ? FIR_ANTISYMMETRIC : FIR_ASYMMETRIC;
+}
+
+// Plain multiply-accumulate
+float firDotScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    float accum = 0.0f;
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        accum += firCoeffs[k] * samples[k];
+    }
+    return accum;
+}
+
+// Folded sum over the first half, sign is +1 for symmetric and -1 for antisymmetric taps
+static inline float dotFoldedScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs, float sign) {
+    int half = numFIRCoeffs / 2;
+    float accum = 0.0f;
+    for (int k = 0; k < half; k++) {
+        accum += firCoeffs[k] * (samples[k] + sign * samples[numFIRCoeffs - 1 - k]);
+    }
+    // Odd length: the centre tap has no partner (and is zero if antisymmetric)
+    if (numFIRCoeffs & 1) {
+        accum += firCoeffs[half] * samples[half];
+    }
+    return accum;
+}
+
+float firDotSymmetricScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    return dotFoldedScalar(firCoeffs, samples, numFIRCoeffs, 1.0f);
+}
+
+float firDotAntisymmetricScalar(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    return dotFoldedScalar(firCoeffs, samples, numFIRCoeffs, -1.0f);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 4 lanes
+__attribute__((target("sse")))
+float firDotSSE(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    __m128 acc = _mm_setzero_ps();
+    int k = 0;
+    for (; k + 4 <= numFIRCoeffs; k += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(firCoeffs + k), _mm_loadu_ps(samples + k)));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    float accum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; k < numFIRCoeffs; k++) {
+        accum += firCoeffs[k] * samples[k];
+    }
+    return accum;
+}
+
+// 2 x 8 lanes with fused multiply-add
+__attribute__((target("avx2,fma")))
+float firDotAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int k = 0;
+    for (; k + 16 <= numFIRCoeffs; k += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(firCoeffs + k), _mm256_loadu_ps(samples + k), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(firCoeffs + k + 8), _mm256_loadu_ps(samples + k + 8), acc1);
+    }
+    for (; k + 8 <= numFIRCoeffs; k += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(firCoeffs + k), _mm256_loadu_ps(samples + k), acc0);
+    }
+
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    float accum = _mm_cvtss_f32(sum);
+    for (; k < numFIRCoeffs; k++) {
+        accum += firCoeffs[k] * samples[k];
+    }
+    return accum;
+}
+
+// 2 x 16 lanes, masked tail
+__attribute__((target("avx512f")))
+float firDotAVX512(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    int k = 0;
+    for (; k + 32 <= numFIRCoeffs; k += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(firCoeffs + k), _mm512_loadu_ps(samples + k), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(firCoeffs + k + 16), _mm512_loadu_ps(samples + k + 16), acc1);
+    }
+    for (; k < numFIRCoeffs; k += 16) {
+        int remaining = numFIRCoeffs - k;
+        __mmask16 mask = remaining >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << remaining) - 1);
+        acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, firCoeffs + k), _mm512_maskz_loadu_ps(mask, samples + k), acc0);
+    }
+
+    // Halve the vector in registers until one lane is left, a serial sum over 16 stored
+    // lanes costs more than the whole dot product for short filters
+    __m512 sum16 = _mm512_add_ps(acc0, acc1);
+    sum16 = _mm512_add_ps(sum16, _mm512_mask_shuffle_f32x4(sum16, 0xFFFF, sum16, sum16, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum16 = _mm512_add_ps(sum16, _mm512_mask_shuffle_f32x4(sum16, 0xFFFF, sum16, sum16, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128 sum4 = _mm512_mask_extractf32x4_ps(_mm_setzero_ps(), 0xF, sum16, 0);
+    __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    return _mm_cvtss_f32(_mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1)));
+}
+
+// Folded version of the AVX2 kernel. The mirrored samples are loaded from the
+// end of the window and reversed within the vector before the add.
+__attribute__((target("avx2,fma")))
+static inline float dotFoldedAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs, float sign) {
+    const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 signs = _mm256_set1_ps(sign);
+    int half = numFIRCoeffs / 2;
+    __m256 acc = _mm256_setzero_ps();
+    int k = 0;
+    for (; k + 8 <= half; k += 8) {
+        __m256 head = _mm256_loadu_ps(samples + k);
+        __m256 tail = _mm256_permutevar8x32_ps(_mm256_loadu_ps(samples + numFIRCoeffs - 8 - k), reverse);
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(firCoeffs + k), _mm256_fmadd_ps(signs, tail, head), acc);
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc);
+    float accum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    for (; k < half; k++) {
+        accum += firCoeffs[k] * (samples[k] + sign * samples[numFIRCoeffs - 1 - k]);
+    }
+    if (numFIRCoeffs & 1) {
+        accum += firCoeffs[half] * samples[half];
+    }
+    return accum;
+}
+
+__attribute__((target("avx2,fma")))
+float firDotSymmetricAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    return dotFoldedAVX2(firCoeffs, samples, numFIRCoeffs, 1.0f);
+}
+
+__attribute__((target("avx2,fma")))
+float firDotAntisymmetricAVX2(const float *firCoeffs, const float *samples, int numFIRCoeffs) {
+    return dotFoldedAVX2(firCoeffs, samples, numFIRCoeffs, -1.0f);
+}
+
+#endif
+
+// Kernels supported by the host CPU
+int firAvailableKernels(FIRKernelInfo *kernels, int maxKernels, FIRSymmetry symmetry, int numFIRCoeffs) {
+    int count = 0;
+
+    // Specializations for fixed tap counts come last, they are the fastest
+    FIRKernelInfo fixedKernel;
+    bool hasFixed = firFixedKernel(symmetry, numFIRCoeffs, &fixedKernel);
+
+    if (symmetry != FIR_ASYMMETRIC) {
+        bool isSymmetric = (symmetry == FIR_SYMMETRIC);
+        if (count < maxKernels) {
+            kernels[count++] = {isSymmetric ? "scalar-sym" : "scalar-antisym",
+                                isSymmetric ? firDotSymmetricScalar : firDotAntisymmetricScalar};
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (count < maxKernels && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            kernels[count++] = {isSymmetric ? "avx2-sym" : "avx2-antisym",
+                                isSymmetric ? firDotSymmetricAVX2 : firDotAntisymmetricAVX2};
+        }
+#endif
+        if (count < maxKernels && hasFixed) {
+            kernels[count++] = fixedKernel;
+        }
+        return count;
+    }
+
+    if (count < maxKernels) {
+        kernels[count++] = {"scalar", firDotScalar};
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (count < maxKernels && __builtin_cpu_supports("sse")) {
+        kernels[count++] = {"sse", firDotSSE};
+    }
+    if (count < maxKernels && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels[count++] = {"avx2", firDotAVX2};
+    }
+    if (count < maxKernels && __builtin_cpu_supports("avx512f")) {
+        kernels[count++] = {"avx512", firDotAVX512};
+    }
+#endif
+    if (count < maxKernels && hasFixed) {
+        kernels[count++] = fixedKernel;
+    }
+    return count;
+}
+
+// Last entry is the widest supported instruction set. Below 256 taps the AVX-512
+// kernel loses to AVX2 (masked tail, reduction), so it is only picked for long filters.
+FIRKernelInfo firSelectKernel(FIRSymmetry symmetry, int numFIRCoeffs) {
+    FIRKernelInfo kernels[5];
+    int count = firAvailableKernels(kernels, 5, symmetry, numFIRCoeffs);
+#if defined(__x86_64__) || defined(__i386__)
+    if (count > 1 && numFIRCoeffs < 256 && kernels[count - 1].dot == firDotAVX512) {
+        count--;
+    }
+#endif
+    return kernels[count - 1];
+}
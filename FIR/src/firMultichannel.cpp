@@ -0,0 +1,154 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/firMultichannel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Padding so vector loads past the last frame stay inside the buffers
+#define LANE_PADDING 8
+
+// Portable version, the loop over channels is left to the auto-vectorizer
+static void laneKernelScalar(const float *laneCoeffs, const float *window, float *outputFrame,
+                             int numFIRCoeffs, int numLanes) {
+    for (int ch = 0; ch < numLanes; ch++) {
+        outputFrame[ch] = 0.0f;
+    }
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        const float *h = laneCoeffs + k * numLanes;
+        const float *x = window + k * numLanes;
+        for (int ch = 0; ch < numLanes; ch++) {
+            outputFrame[ch] += h[ch] * x[ch];
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 1, 2, 4 or 8 lanes: one 8-lane vector covers 8/numLanes taps of every channel.
+// Sweep the whole window and fold the lanes back onto the channels at the end.
+__attribute__((target("avx2,fma")))
+static void laneKernelAVX2Packed(const float *laneCoeffs, const float *window, float *outputFrame,
+                                 int numFIRCoeffs, int numLanes) {
+    int length = numFIRCoeffs * numLanes;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= length; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(laneCoeffs + i), _mm256_loadu_ps(window + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(laneCoeffs + i + 8), _mm256_loadu_ps(window + i + 8), acc1);
+    }
+    // Zero padded coefficients make the last partial vector safe
+    for (; i < length; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(laneCoeffs + i), _mm256_loadu_ps(window + i), acc0);
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, _mm256_add_ps(acc0, acc1));
+    for (int ch = 0; ch < numLanes; ch++) {
+        outputFrame[ch] = 0.0f;
+    }
+    for (int j = 0; j < 8; j++) {
+        outputFrame[j % numLanes] += lanes[j];
+    }
+}
+
+// Multiples of 8 lanes: every vector holds 8 channels of one tap
+__attribute__((target("avx2,fma")))
+static void laneKernelAVX2Wide(const float *laneCoeffs, const float *window, float *outputFrame,
+                               int numFIRCoeffs, int numLanes) {
+    for (int ch = 0; ch < numLanes; ch += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < numFIRCoeffs; k++) {
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(laneCoeffs + k * numLanes + ch),
+                                  _mm256_loadu_ps(window + k * numLanes + ch), acc);
+        }
+        _mm256_storeu_ps(outputFrame + ch, acc);
+    }
+}
+
+#endif
+
+// Pick the kernel for the channel count and host CPU. The vector kernels get the frame
+// padded to the next power of two up to 8 lanes, or to a multiple of 8 lanes; the padding
+// lanes hold zeros and are never written to the output.
+static FIRLaneKernel selectLaneKernel(int numChannels, int *numLanes) {
+    *numLanes = numChannels;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        if (numChannels <= 8) {
+            while (8 % *numLanes != 0) {
+                (*numLanes)++;
+            }
+            return laneKernelAVX2Packed;
+        }
+        *numLanes = (numChannels + 7) / 8 * 8;
+        return laneKernelAVX2Wide;
+    }
+#endif
+    return laneKernelScalar;
+}
+
+int firMultiInit(FIRMultiFilter *filter, const float *firCoeffs, int numFIRCoeffs, int numChannels) {
+    filter->numFIRCoeffs = numFIRCoeffs;
+    filter->numChannels = numChannels;
+    filter->bufferIndex = 0;
+    filter->kernel = selectLaneKernel(numChannels, &filter->numLanes);
+
+    int numLanes = filter->numLanes;
+    int length = numFIRCoeffs * numLanes;
+    filter->laneCoeffs = (float*)calloc(length + LANE_PADDING, sizeof(float));
+    filter->buffer = (float*)calloc(2 * length + LANE_PADDING, sizeof(float));
+    filter->laneFrame = (float*)malloc(numLanes * sizeof(float));
+    if (!filter->laneCoeffs || !filter->buffer || !filter->laneFrame) {
+        firMultiFree(filter);
+        return -1;
+    }
+
+    for (int k = 0; k < numFIRCoeffs; k++) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            filter->laneCoeffs[k * numLanes + ch] = firCoeffs[k];
+        }
+    }
+    return 0;
+}
+
+void firMultiFree(FIRMultiFilter *filter) {
+    free(filter->laneCoeffs);
+    free(filter->buffer);
+    free(filter->laneFrame);
+    filter->laneCoeffs = NULL;
+    filter->buffer = NULL;
+    filter->laneFrame = NULL;
+}
+
+// Mirrored frame buffer FIR filtering
+void processMultichannel(FIRMultiFilter *filter, const float *input, float *output, int numFrames) {
+    int numFIRCoeffs = filter->numFIRCoeffs;
+    int numChannels = filter->numChannels;
+    int numLanes = filter->numLanes;
+    size_t frameBytes = numChannels * sizeof(float);
+    int bufferIndex = filter->bufferIndex;
+
+    for (int n = 0; n < numFrames; n++) {
+        // Step back one frame, the new frame is the first one of the window
+        bufferIndex = (bufferIndex == 0) ? numFIRCoeffs - 1 : bufferIndex - 1;
+
+        // Insert the new frame in both halves of the buffer, the padding lanes stay zero
+        const float *frame = input + n * numChannels;
+        memcpy(filter->buffer + bufferIndex * numLanes, frame, frameBytes);
+        memcpy(filter->buffer + (bufferIndex + numFIRCoeffs) * numLanes, frame, frameBytes);
+
+        // Without padding the kernel writes straight to the output
+        float *outputFrame = (numLanes == numChannels) ? output + n * numChannels : filter->laneFrame;
+        filter->kernel(filter->laneCoeffs, filter->buffer + bufferIndex * numLanes, outputFrame, numFIRCoeffs,
+                       numLanes);
+        if (outputFrame == filter->laneFrame) {
+            memcpy(output + n * numChannels, outputFrame, frameBytes);
+        }
+    }
+
+    filter->bufferIndex = bufferIndex;
+}
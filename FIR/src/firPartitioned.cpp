@@ -0,0 +1,103 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/firPartitioned.h"
+
+int firPartitionedInit(FIRPartitionedFilter *filter, const float *firCoeffs, int numFIRCoeffs, int partitionSize) {
+    memset(filter, 0, sizeof(FIRPartitionedFilter));
+    if (fftInit(&filter->plan, 2 * partitionSize) != 0) {
+        return -1;
+    }
+
+    int numBins = partitionSize + 1;
+    filter->numFIRCoeffs = numFIRCoeffs;
+    filter->partitionSize = partitionSize;
+    filter->numPartitions = (numFIRCoeffs + partitionSize - 1) / partitionSize;
+    filter->latency = partitionSize;
+    filter->coeffSpectra = (Complex*)malloc(filter->numPartitions * numBins * sizeof(Complex));
+    filter->fdl = (Complex*)calloc(filter->numPartitions * numBins, sizeof(Complex));
+    filter->accum = (Complex*)malloc(numBins * sizeof(Complex));
+    filter->timeBuffer = (float*)calloc(2 * partitionSize, sizeof(float));
+    filter->outputBlock = (float*)calloc(2 * partitionSize, sizeof(float));
+    if (!filter->coeffSpectra || !filter->fdl || !filter->accum || !filter->timeBuffer || !filter->outputBlock) {
+        firPartitionedFree(filter);
+        return -1;
+    }
+
+    // Spectrum of each zero padded partition
+    for (int p = 0; p < filter->numPartitions; p++) {
+        int count = numFIRCoeffs - p * partitionSize;
+        if (count > partitionSize) {
+            count = partitionSize;
+        }
+        memset(filter->timeBuffer, 0, 2 * partitionSize * sizeof(float));
+        memcpy(filter->timeBuffer, firCoeffs + p * partitionSize, count * sizeof(float));
+        fftRealForward(&filter->plan, filter->timeBuffer, filter->coeffSpectra + p * numBins);
+    }
+    memset(filter->timeBuffer, 0, 2 * partitionSize * sizeof(float));
+    return 0;
+}
+
+void firPartitionedFree(FIRPartitionedFilter *filter) {
+    fftFree(&filter->plan);
+    free(filter->coeffSpectra);
+    free(filter->fdl);
+    free(filter->accum);
+    free(filter->timeBuffer);
+    free(filter->outputBlock);
+    filter->coeffSpectra = NULL;
+    filter->fdl = NULL;
+    filter->accum = NULL;
+    filter->timeBuffer = NULL;
+    filter->outputBlock = NULL;
+}
+
+// One block: transform the newest 2P samples into the FDL, multiply-accumulate
+// every partition with the input spectrum of matching age, transform back
+static void processBlock(FIRPartitionedFilter *filter) {
+    int partitionSize = filter->partitionSize;
+    int numBins = partitionSize + 1;
+    int numPartitions = filter->numPartitions;
+
+    filter->fdlIndex = (filter->fdlIndex == 0) ? numPartitions - 1 : filter->fdlIndex - 1;
+    fftRealForward(&filter->plan, filter->timeBuffer, filter->fdl + filter->fdlIndex * numBins);
+
+    memset(filter->accum, 0, numBins * sizeof(Complex));
+    int slot = filter->fdlIndex;
+    for (int p = 0; p < numPartitions; p++) {
+        const Complex *x = filter->fdl + slot * numBins;
+        const Complex *h = filter->coeffSpectra + p * numBins;
+        Complex *acc = filter->accum;
+        for (int k = 0; k < numBins; k++) {
+            acc[k].real += x[k].real * h[k].real - x[k].imag * h[k].imag;
+            acc[k].imag += x[k].real * h[k].imag + x[k].imag * h[k].real;
+        }
+        slot = (slot + 1 == numPartitions) ? 0 : slot + 1;
+    }
+
+    fftRealInverse(&filter->plan, filter->accum, filter->outputBlock);
+
+    // The current block becomes the previous one
+    memcpy(filter->timeBuffer, filter->timeBuffer + partitionSize, partitionSize * sizeof(float));
+}
+
+void firPartitionedProcess(FIRPartitionedFilter *filter, const float *input, float *output, int nSamples) {
+    int partitionSize = filter->partitionSize;
+    int n = 0;
+
+    while (n < nSamples) {
+        // Copy as much as fits into the current block
+        int count = partitionSize - filter->blockIndex;
+        if (count > nSamples - n) {
+            count = nSamples - n;
+        }
+        memcpy(filter->timeBuffer + partitionSize + filter->blockIndex, input + n, count * sizeof(float));
+        memcpy(output + n, filter->outputBlock + partitionSize + filter->blockIndex, count * sizeof(float));
+        filter->blockIndex += count;
+        n += count;
+
+        if (filter->blockIndex == partitionSize) {
+            processBlock(filter);
+            filter->blockIndex = 0;
+        }
+    }
+}
@@ -22,4 +22,10 @@ int read_chunk(FILE *file, double *buffer, int chunkSize);
 // Function to write a chunk of processed data to a CSV file
 void write_chunk(FILE *file, double *data, int dataSize);
 
+// Read up to maxFrames CSV rows of numChannels comma-separated values, interleaved into buffer
+int read_frames(FILE *file, double *buffer, int numChannels, int maxFrames);
+
+// Write numFrames interleaved frames as CSV rows
+void write_frames(FILE *file, double *data, int numChannels, int numFrames);
+
 #endif // DATA_H
@@ -0,0 +1,16 @@
+#ifndef DENORMAL_H
+#define DENORMAL_H
+
+#include <stdbool.h>
+
+// Set flush-to-zero (FTZ) and denormals-are-zero (DAZ) in MXCSR. Subnormal results
+// become zero and subnormal inputs are read as zero, so decaying filter states can no
+// longer slow the cascade down. Call it at the start of main, threads created afterwards
+// inherit the mode. Returns false on targets without MXCSR.
+bool enable_flush_to_zero(void);
+
+// Number of subnormal values, checked on the bit pattern so it also works with DAZ set
+int count_subnormals(const double* data, int n);
+int count_subnormals_f(const float* data, int n);
+
+#endif // DENORMAL_H
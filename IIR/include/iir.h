@@ -6,6 +6,10 @@
 // Process the input data in chunks
 void process_chunk(double* input_chunk, double* output_chunk, size_t size, Biquad* filters, size_t num_filters);
 
+// process_chunk that also adds the number of subnormal outputs of stage j to stage_counts[j]
+void process_chunk_counted(double* input_chunk, double* output_chunk, size_t size, Biquad* filters, size_t num_filters,
+                           long* stage_counts);
+
 // Process each chunk with serially-cascaded IIR filters
 double biquad_process(Biquad* filter, double in);
 
@@ -0,0 +1,35 @@
+#ifndef IIR_BLOCK_H
+#define IIR_BLOCK_H
+
+#include "../include/data.h"
+
+// Runs one stage over a chunk in place
+typedef void (*BlockStageKernel)(const double* matrices, double* state, double* data, size_t size);
+
+// Biquad cascade in block state-space (look-ahead) form. Each stage computes block_size
+// outputs at once from its two TDF-II state variables and the block of inputs:
+//   y_block = O * s + T * u_block,   s' = A^L * s + K * u_block
+// O, T and K only depend on the coefficients, so the outputs of a block are independent
+// vector multiply-adds and the feedback only goes through s once per block.
+// See docs/iir_block_state_space.md for the derivation and the accuracy.
+typedef struct {
+    size_t num_stages;
+    int block_size;      // L, 4 or 8
+    int stride;          // doubles of precomputed matrices per stage
+    double* matrices;    // per stage: O column 0 and 1, T columns, K rows 0 and 1, A^L, b0 b1 b2 a1 a2
+    double* state;       // s1, s2 per stage
+    BlockStageKernel kernel;
+    const char* kernel_name;
+} BiquadBlock;
+
+// Precompute the block matrices of every stage and clear the state. block_size must be 4 or 8.
+// Returns 0 on success, -1 on failure.
+int block_init(BiquadBlock* block, const Biquad* filters, size_t num_filters, int block_size);
+
+void block_free(BiquadBlock* block);
+
+// Filter one chunk, input and output may be the same buffer. A tail shorter than the
+// block size runs through the plain TDF-II recursion, so any chunk size works.
+void block_process(BiquadBlock* block, const double* input_chunk, double* output_chunk, size_t size);
+
+#endif // IIR_BLOCK_H
@@ -0,0 +1,34 @@
+#ifndef IIR_CASCADE_H
+#define IIR_CASCADE_H
+
+#include "../include/data.h"
+
+// Biquad cascade in transposed direct form II. A chunk runs through four stages at a
+// time, so the state variables of those stages stay in registers for the whole chunk.
+// Coefficients (b0, b1, b2, a1, a2 per stage) and state (s1, s2 per stage) are kept
+// in separate arrays instead of the mixed Biquad struct.
+typedef struct {
+    size_t num_stages;
+    double* coeffs;
+    double* state;
+} BiquadCascade;
+
+// Single precision version, coefficients are rounded from the double Biquads
+typedef struct {
+    size_t num_stages;
+    float* coeffs;
+    float* state;
+} BiquadCascadeF;
+
+// Copy the coefficients of the loaded Biquads and clear the state. Returns 0 on success, -1 on failure.
+int cascade_init(BiquadCascade* cascade, const Biquad* filters, size_t num_filters);
+int cascade_init_f(BiquadCascadeF* cascade, const Biquad* filters, size_t num_filters);
+
+void cascade_free(BiquadCascade* cascade);
+void cascade_free_f(BiquadCascadeF* cascade);
+
+// Filter one chunk, input and output may be the same buffer
+void cascade_process(BiquadCascade* cascade, const double* input_chunk, double* output_chunk, size_t size);
+void cascade_process_f(BiquadCascadeF* cascade, const float* input_chunk, float* output_chunk, size_t size);
+
+#endif // IIR_CASCADE_H
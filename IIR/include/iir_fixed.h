@@ -0,0 +1,49 @@
+#ifndef IIR_FIXED_H
+#define IIR_FIXED_H
+
+#include <stdint.h>
+#include "../include/data.h"
+
+// Coefficient quantization: round to nearest or truncate towards minus infinity
+typedef enum {
+    QUANT_ROUND,
+    QUANT_TRUNCATE
+} quant_mode;
+
+// Fixed-point biquads in direct form I. Samples are Q15 or Q31 relative to a full
+// scale chosen by the caller. Coefficients use the same word length with coeff_shift
+// integer bits (a1 can reach +-2), so their format is Q(15-coeff_shift) or Q(31-coeff_shift).
+// Each stage sums in 64 bits with saturating adds and rounds and saturates its output.
+// Rounding noise of a stage is amplified by the high-Q stages after it, so deep
+// cascades like the 64-stage design in data/ lose accuracy quickly, even in Q31.
+typedef struct {
+    int16_t b0, b1, b2, a1, a2;
+    int coeff_shift;
+    int16_t x1, x2, y1, y2;
+} BiquadQ15;
+
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;
+    int coeff_shift;
+    int32_t x1, x2, y1, y2;
+} BiquadQ31;
+
+// Quantize the coefficients of a double biquad and clear the state
+void biquad_init_q15(BiquadQ15* filter, const Biquad* reference, quant_mode mode);
+void biquad_init_q31(BiquadQ31* filter, const Biquad* reference, quant_mode mode);
+
+// Single stage
+int16_t biquad_process_q15(BiquadQ15* filter, int16_t in);
+int32_t biquad_process_q31(BiquadQ31* filter, int32_t in);
+
+// Run a chunk through the cascade
+void process_chunk_q15(const int16_t* input_chunk, int16_t* output_chunk, size_t size, BiquadQ15* filters, size_t num_filters);
+void process_chunk_q31(const int32_t* input_chunk, int32_t* output_chunk, size_t size, BiquadQ31* filters, size_t num_filters);
+
+// Sample conversion with saturation; full_scale maps to 1.0
+int16_t double_to_q15(double value, double full_scale);
+int32_t double_to_q31(double value, double full_scale);
+double q15_to_double(int16_t value, double full_scale);
+double q31_to_double(int32_t value, double full_scale);
+
+#endif // IIR_FIXED_H
@@ -0,0 +1,35 @@
+#ifndef IIR_MULTICHANNEL_H
+#define IIR_MULTICHANNEL_H
+
+#include "../include/data.h"
+
+// Runs one group of channels through stages [0, num_stages) over num_frames samples
+typedef void (*MultiGroupKernel)(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames);
+
+// The same biquad cascade on many independent channels. Channels are split into
+// groups of `width` (4, 8 or 16) that share every vector instruction, so a group
+// costs about what one channel costs in the scalar cascade. State is stored as
+// structure of arrays: per group and stage, s1 for all lanes followed by s2 for all lanes.
+typedef struct {
+    size_t num_stages;
+    int num_channels;
+    int width;
+    int num_groups;
+    int max_frames;
+    double* coeffs;  // b0, b1, b2, a1, a2 per stage, shared by all channels
+    double* state;   // num_groups * num_stages * 2 * width
+    double* work;    // one group of deinterleaved frames, max_frames * width
+    MultiGroupKernel kernel;
+    const char* kernel_name;
+} BiquadMulti;
+
+// Copy the cascade and clear the state. width must be 4, 8 or 16, max_frames is the
+// largest chunk passed to process_multichannel. Returns 0 on success, -1 on failure.
+int multi_init(BiquadMulti* multi, const Biquad* filters, size_t num_filters, int num_channels, int width, int max_frames);
+
+void multi_free(BiquadMulti* multi);
+
+// Filter num_frames interleaved frames of num_channels samples, input and output may be the same buffer
+void process_multichannel(BiquadMulti* multi, const double* input, double* output, int num_frames);
+
+#endif // IIR_MULTICHANNEL_H
@@ -59,3 +59,26 @@ void write_chunk(FILE *file, double *data, int dataSize) {
         fprintf(file, "%.2f\n", data[i]);
     }
 }
+
+// Read a chunk of multichannel rows, a partial last row is dropped
+int read_frames(FILE *file, double *buffer, int numChannels, int maxFrames) {
+    int frames = 0;
+    while (frames < maxFrames) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            if (fscanf(file, ch == 0 ? " %lf" : " ,%lf", &buffer[frames * numChannels + ch]) != 1) {
+                return frames;
+            }
+        }
+        frames++;
+    }
+    return frames;
+}
+
+// Write a chunk of multichannel rows
+void write_frames(FILE *file, double *data, int numChannels, int numFrames) {
+    for (int n = 0; n < numFrames; n++) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            fprintf(file, ch + 1 < numChannels ? "%.2f," : "%.2f\n", data[n * numChannels + ch]);
+        }
+    }
+}
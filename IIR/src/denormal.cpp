@@ -0,0 +1,37 @@
+#include <stdint.h>
+#include <string.h>
+#include "../include/denormal.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+bool enable_flush_to_zero(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    // FTZ is bit 15, DAZ is bit 6
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Exponent bits all zero, mantissa not zero
+int count_subnormals(const double* data, int n) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        count += ((bits & 0x7FF0000000000000ull) == 0 && (bits & 0x000FFFFFFFFFFFFFull) != 0) ? 1 : 0;
+    }
+    return count;
+}
+
+int count_subnormals_f(const float* data, int n) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        count += ((bits & 0x7F800000u) == 0 && (bits & 0x007FFFFFu) != 0) ? 1 : 0;
+    }
+    return count;
+}
@@ -1,4 +1,5 @@
 #include "../include/iir.h"
+#include "../include/denormal.h"
 
 // Proess chunk of data
 void process_chunk(double* input_chunk, double* output_chunk, size_t nSamples, Biquad* filters, size_t num_filters) {
@@ -11,6 +12,19 @@ void process_chunk(double* input_chunk, double* output_chunk, size_t nSamples, B
     }
 }
 
+// Same cascade, every stage output is checked on its way to the next stage
+void process_chunk_counted(double* input_chunk, double* output_chunk, size_t nSamples, Biquad* filters, size_t num_filters,
+                           long* stage_counts) {
+    for (size_t i = 0; i < nSamples; ++i) {
+        double sample = input_chunk[i];
+        for (size_t j = 0; j < num_filters; ++j) {
+            sample = biquad_process(&filters[j], sample);
+            stage_counts[j] += count_subnormals(&sample, 1);
+        }
+        output_chunk[i] = sample;
+    }
+}
+
 // Single Biquad filter stage processing
 double biquad_process(Biquad* filter, double in) {
     double out = filter->b0 * in + filter->b1 * filter->x1 + filter->b2 * filter->x2
@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/iir_block.h"
+
+// Stage layout, L = block size:
+// O0[L] O1[L] | T[L][L] (column k starts at k*L) | K0[L] K1[L] | A^L[4] | b0 b1 b2 a1 a2
+static int stage_stride(int L) {
+    return 2 * L + L * L + 2 * L + 4 + 5;
+}
+
+// State space form of one TDF-II biquad with state s = (s1, s2):
+//   y = b0*u + s1
+//   s1' = -a1*s1 + s2 + (b1 - a1*b0)*u
+//   s2' = -a2*s1      + (b2 - a2*b0)*u
+// so A = [-a1 1; -a2 0], B = [b1 - a1*b0; b2 - a2*b0], C = [1 0], D = b0.
+static void build_stage(const Biquad* filter, int L, double* m) {
+    double A[4] = {-filter->a1, 1.0, -filter->a2, 0.0};
+    double B[2] = {filter->b1 - filter->a1 * filter->b0, filter->b2 - filter->a2 * filter->b0};
+    double* O0 = m;
+    double* O1 = m + L;
+    double* T = m + 2 * L;
+    double* K0 = T + L * L;
+    double* K1 = K0 + L;
+    double* AL = K1 + L;
+    double* coeffs = AL + 4;
+
+    // O row i = C * A^i, the first row of A^i
+    double P[4] = {1.0, 0.0, 0.0, 1.0};
+    double h[8];  // impulse response, h[0] = D, h[i] = C * A^(i-1) * B
+    h[0] = filter->b0;
+    for (int i = 0; i < L; i++) {
+        O0[i] = P[0];
+        O1[i] = P[1];
+        if (i + 1 < L) {
+            h[i + 1] = P[0] * B[0] + P[1] * B[1];
+        }
+        double next[4] = {P[0] * A[0] + P[1] * A[2], P[0] * A[1] + P[1] * A[3],
+                          P[2] * A[0] + P[3] * A[2], P[2] * A[1] + P[3] * A[3]};
+        memcpy(P, next, sizeof(P));
+    }
+    memcpy(AL, P, sizeof(P));
+
+    // T is lower triangular Toeplitz, T[i][k] = h[i - k]
+    for (int k = 0; k < L; k++) {
+        for (int i = 0; i < L; i++) {
+            T[k * L + i] = (i >= k) ? h[i - k] : 0.0;
+        }
+    }
+
+    // Column k of K = A^(L-1-k) * B, built backwards from B
+    double v[2] = {B[0], B[1]};
+    for (int k = L - 1; k >= 0; k--) {
+        K0[k] = v[0];
+        K1[k] = v[1];
+        double next[2] = {A[0] * v[0] + A[1] * v[1], A[2] * v[0] + A[3] * v[1]};
+        v[0] = next[0];
+        v[1] = next[1];
+    }
+
+    coeffs[0] = filter->b0;
+    coeffs[1] = filter->b1;
+    coeffs[2] = filter->b2;
+    coeffs[3] = filter->a1;
+    coeffs[4] = filter->a2;
+}
+
+// One stage over the chunk. The L outputs of a block are built column by column from
+// broadcast inputs, the state update is two dot products that do not depend on s.
+template <int L>
+__attribute__((always_inline)) inline void block_stage(const double* m, double* state, double* data, size_t size) {
+    typedef double vec __attribute__((vector_size(L * sizeof(double))));
+    const double* T = m + 2 * L;
+    const double* K0 = T + L * L;
+    const double* K1 = K0 + L;
+    const double* AL = K1 + L;
+    const double* coeffs = AL + 4;
+    vec O0, O1, Tk[L];
+    memcpy(&O0, m, sizeof(vec));
+    memcpy(&O1, m + L, sizeof(vec));
+    for (int k = 0; k < L; k++) {
+        memcpy(&Tk[k], T + k * L, sizeof(vec));
+    }
+    double s1 = state[0];
+    double s2 = state[1];
+
+    size_t n = 0;
+    for (; n + L <= size; n += L) {
+        const double* u = data + n;
+        vec y = O0 * s1 + O1 * s2;
+        double k0 = 0.0;
+        double k1 = 0.0;
+        for (int k = 0; k < L; k++) {
+            y += Tk[k] * u[k];
+            k0 += K0[k] * u[k];
+            k1 += K1[k] * u[k];
+        }
+        double next1 = AL[0] * s1 + AL[1] * s2 + k0;
+        double next2 = AL[2] * s1 + AL[3] * s2 + k1;
+        s1 = next1;
+        s2 = next2;
+        memcpy(data + n, &y, sizeof(vec));
+    }
+
+    // Remaining samples, TDF-II one at a time
+    for (; n < size; n++) {
+        double x = data[n];
+        double y = coeffs[0] * x + s1;
+        s1 = coeffs[1] * x - coeffs[3] * y + s2;
+        s2 = coeffs[2] * x - coeffs[4] * y;
+        data[n] = y;
+    }
+    state[0] = s1;
+    state[1] = s2;
+}
+
+static void block_stage_4(const double* m, double* state, double* data, size_t size) {
+    block_stage<4>(m, state, data, size);
+}
+
+static void block_stage_8(const double* m, double* state, double* data, size_t size) {
+    block_stage<8>(m, state, data, size);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2,fma")))
+static void block_stage_4_avx2(const double* m, double* state, double* data, size_t size) {
+    block_stage<4>(m, state, data, size);
+}
+
+__attribute__((target("avx2,fma")))
+static void block_stage_8_avx2(const double* m, double* state, double* data, size_t size) {
+    block_stage<8>(m, state, data, size);
+}
+
+__attribute__((target("avx512f")))
+static void block_stage_8_avx512(const double* m, double* state, double* data, size_t size) {
+    block_stage<8>(m, state, data, size);
+}
+#endif
+
+// Widest instruction set the host supports for the block size
+static BlockStageKernel select_kernel(int L, const char** name) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (L == 8 && __builtin_cpu_supports("avx512f")) {
+        *name = "avx512";
+        return block_stage_8_avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        *name = "avx2";
+        return (L == 4) ? block_stage_4_avx2 : block_stage_8_avx2;
+    }
+#endif
+    *name = "generic";
+    return (L == 4) ? block_stage_4 : block_stage_8;
+}
+
+int block_init(BiquadBlock* block, const Biquad* filters, size_t num_filters, int block_size) {
+    if (num_filters == 0 || (block_size != 4 && block_size != 8)) {
+        return -1;
+    }
+    block->num_stages = num_filters;
+    block->block_size = block_size;
+    block->stride = stage_stride(block_size);
+    block->matrices = (double*)malloc(num_filters * block->stride * sizeof(double));
+    block->state = (double*)calloc(2 * num_filters, sizeof(double));
+    block->kernel = select_kernel(block_size, &block->kernel_name);
+    if (!block->matrices || !block->state) {
+        block_free(block);
+        return -1;
+    }
+
+    for (size_t j = 0; j < num_filters; ++j) {
+        build_stage(&filters[j], block_size, &block->matrices[j * block->stride]);
+    }
+    return 0;
+}
+
+void block_free(BiquadBlock* block) {
+    free(block->matrices);
+    free(block->state);
+    block->matrices = NULL;
+    block->state = NULL;
+}
+
+// Stage by stage over the whole chunk, in place on the output
+void block_process(BiquadBlock* block, const double* input_chunk, double* output_chunk, size_t size) {
+    if (input_chunk != output_chunk) {
+        memcpy(output_chunk, input_chunk, size * sizeof(double));
+    }
+    for (size_t j = 0; j < block->num_stages; ++j) {
+        block->kernel(&block->matrices[j * block->stride], &block->state[2 * j], output_chunk, size);
+    }
+}
@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include "../include/iir_cascade.h"
+
+// Coefficients in stage order: b0, b1, b2, a1, a2
+template <typename T>
+static T* copy_coefficients(const Biquad* filters, size_t num_filters) {
+    T* coeffs = (T*)malloc(5 * num_filters * sizeof(T));
+    if (!coeffs) {
+        return NULL;
+    }
+    for (size_t j = 0; j < num_filters; ++j) {
+        coeffs[5 * j + 0] = (T)filters[j].b0;
+        coeffs[5 * j + 1] = (T)filters[j].b1;
+        coeffs[5 * j + 2] = (T)filters[j].b2;
+        coeffs[5 * j + 3] = (T)filters[j].a1;
+        coeffs[5 * j + 4] = (T)filters[j].a2;
+    }
+    return coeffs;
+}
+
+// A group of stages over the whole chunk, TDF-II per stage:
+// y = b0*x + s1, s1 = b1*x - a1*y + s2, s2 = b2*x - a2*y
+// One stage per pass would serialize on its feedback latency, with several stages per
+// pass their recurrences overlap while the state still stays in registers.
+template <typename T, int GROUP>
+static void process_stages(const T* coeffs, T* state, const T* input, T* output, size_t size) {
+    T b0[GROUP], b1[GROUP], b2[GROUP], a1[GROUP], a2[GROUP], s1[GROUP], s2[GROUP];
+    for (int g = 0; g < GROUP; ++g) {
+        b0[g] = coeffs[5 * g + 0];
+        b1[g] = coeffs[5 * g + 1];
+        b2[g] = coeffs[5 * g + 2];
+        a1[g] = coeffs[5 * g + 3];
+        a2[g] = coeffs[5 * g + 4];
+        s1[g] = state[2 * g + 0];
+        s2[g] = state[2 * g + 1];
+    }
+    for (size_t i = 0; i < size; ++i) {
+        T x = input[i];
+        for (int g = 0; g < GROUP; ++g) {
+            T y = b0[g] * x + s1[g];
+            s1[g] = b1[g] * x - a1[g] * y + s2[g];
+            s2[g] = b2[g] * x - a2[g] * y;
+            x = y;
+        }
+        output[i] = x;
+    }
+    for (int g = 0; g < GROUP; ++g) {
+        state[2 * g + 0] = s1[g];
+        state[2 * g + 1] = s2[g];
+    }
+}
+
+// First pass reads the input, the others work in place on the output
+template <typename T>
+static void process_cascade(const T* coeffs, T* state, size_t num_stages, const T* input_chunk, T* output_chunk, size_t size) {
+    const T* stage_input = input_chunk;
+    size_t j = 0;
+    for (; j + 4 <= num_stages; j += 4) {
+        process_stages<T, 4>(&coeffs[5 * j], &state[2 * j], stage_input, output_chunk, size);
+        stage_input = output_chunk;
+    }
+    for (; j < num_stages; ++j) {
+        process_stages<T, 1>(&coeffs[5 * j], &state[2 * j], stage_input, output_chunk, size);
+        stage_input = output_chunk;
+    }
+}
+
+int cascade_init(BiquadCascade* cascade, const Biquad* filters, size_t num_filters) {
+    cascade->num_stages = num_filters;
+    cascade->coeffs = copy_coefficients<double>(filters, num_filters);
+    cascade->state = (double*)calloc(2 * num_filters, sizeof(double));
+    if (num_filters == 0 || !cascade->coeffs || !cascade->state) {
+        cascade_free(cascade);
+        return -1;
+    }
+    return 0;
+}
+
+int cascade_init_f(BiquadCascadeF* cascade, const Biquad* filters, size_t num_filters) {
+    cascade->num_stages = num_filters;
+    cascade->coeffs = copy_coefficients<float>(filters, num_filters);
+    cascade->state = (float*)calloc(2 * num_filters, sizeof(float));
+    if (num_filters == 0 || !cascade->coeffs || !cascade->state) {
+        cascade_free_f(cascade);
+        return -1;
+    }
+    return 0;
+}
+
+void cascade_free(BiquadCascade* cascade) {
+    free(cascade->coeffs);
+    free(cascade->state);
+    cascade->coeffs = NULL;
+    cascade->state = NULL;
+}
+
+void cascade_free_f(BiquadCascadeF* cascade) {
+    free(cascade->coeffs);
+    free(cascade->state);
+    cascade->coeffs = NULL;
+    cascade->state = NULL;
+}
+
+void cascade_process(BiquadCascade* cascade, const double* input_chunk, double* output_chunk, size_t size) {
+    process_cascade(cascade->coeffs, cascade->state, cascade->num_stages, input_chunk, output_chunk, size);
+}
+
+void cascade_process_f(BiquadCascadeF* cascade, const float* input_chunk, float* output_chunk, size_t size) {
+    process_cascade(cascade->coeffs, cascade->state, cascade->num_stages, input_chunk, output_chunk, size);
+}
@@ -0,0 +1,150 @@
+#include <math.h>
+#include "../include/iir_fixed.h"
+
+// Scale, quantize and clamp to [min_value, max_value]
+static int64_t quantize(double value, int frac_bits, quant_mode mode, int64_t min_value, int64_t max_value) {
+    double scaled = ldexp(value, frac_bits);
+    scaled = (mode == QUANT_ROUND) ? floor(scaled + 0.5) : floor(scaled);
+    if (scaled > (double)max_value) {
+        return max_value;
+    }
+    if (scaled < (double)min_value) {
+        return min_value;
+    }
+    return (int64_t)scaled;
+}
+
+// Integer bits needed so every coefficient magnitude is below 2^shift
+static int coeff_headroom(const Biquad* reference) {
+    double max_coeff = fmax(fmax(fabs(reference->b0), fabs(reference->b1)), fabs(reference->b2));
+    max_coeff = fmax(max_coeff, fmax(fabs(reference->a1), fabs(reference->a2)));
+    int shift = 0;
+    while (shift < 8 && max_coeff >= ldexp(1.0, shift)) {
+        shift++;
+    }
+    return shift;
+}
+
+// Saturating 64-bit add
+static inline int64_t add_saturate(int64_t a, int64_t b) {
+    int64_t sum;
+    if (__builtin_add_overflow(a, b, &sum)) {
+        return (b > 0) ? INT64_MAX : INT64_MIN;
+    }
+    return sum;
+}
+
+// Round away the fractional bits and clamp to the sample range
+static inline int64_t round_shift_saturate(int64_t accum, int shift, int64_t min_value, int64_t max_value) {
+    if (shift > 0) {
+        accum = add_saturate(accum, (int64_t)1 << (shift - 1)) >> shift;
+    }
+    if (accum > max_value) {
+        return max_value;
+    }
+    if (accum < min_value) {
+        return min_value;
+    }
+    return accum;
+}
+
+void biquad_init_q15(BiquadQ15* filter, const Biquad* reference, quant_mode mode) {
+    filter->coeff_shift = coeff_headroom(reference);
+    int frac_bits = 15 - filter->coeff_shift;
+    filter->b0 = (int16_t)quantize(reference->b0, frac_bits, mode, INT16_MIN, INT16_MAX);
+    filter->b1 = (int16_t)quantize(reference->b1, frac_bits, mode, INT16_MIN, INT16_MAX);
+    filter->b2 = (int16_t)quantize(reference->b2, frac_bits, mode, INT16_MIN, INT16_MAX);
+    filter->a1 = (int16_t)quantize(reference->a1, frac_bits, mode, INT16_MIN, INT16_MAX);
+    filter->a2 = (int16_t)quantize(reference->a2, frac_bits, mode, INT16_MIN, INT16_MAX);
+    filter->x1 = filter->x2 = 0;
+    filter->y1 = filter->y2 = 0;
+}
+
+void biquad_init_q31(BiquadQ31* filter, const Biquad* reference, quant_mode mode) {
+    filter->coeff_shift = coeff_headroom(reference);
+    int frac_bits = 31 - filter->coeff_shift;
+    filter->b0 = (int32_t)quantize(reference->b0, frac_bits, mode, INT32_MIN, INT32_MAX);
+    filter->b1 = (int32_t)quantize(reference->b1, frac_bits, mode, INT32_MIN, INT32_MAX);
+    filter->b2 = (int32_t)quantize(reference->b2, frac_bits, mode, INT32_MIN, INT32_MAX);
+    filter->a1 = (int32_t)quantize(reference->a1, frac_bits, mode, INT32_MIN, INT32_MAX);
+    filter->a2 = (int32_t)quantize(reference->a2, frac_bits, mode, INT32_MIN, INT32_MAX);
+    filter->x1 = filter->x2 = 0;
+    filter->y1 = filter->y2 = 0;
+}
+
+// Q15 x Q(15-s) products fit easily, the accumulator only saturates on overflow
+int16_t biquad_process_q15(BiquadQ15* filter, int16_t in) {
+    int shift = 15 - filter->coeff_shift;
+    int64_t accum = (int64_t)filter->b0 * in;
+    accum = add_saturate(accum, (int64_t)filter->b1 * filter->x1);
+    accum = add_saturate(accum, (int64_t)filter->b2 * filter->x2);
+    accum = add_saturate(accum, -(int64_t)filter->a1 * filter->y1);
+    accum = add_saturate(accum, -(int64_t)filter->a2 * filter->y2);
+    int16_t out = (int16_t)round_shift_saturate(accum, shift, INT16_MIN, INT16_MAX);
+
+    filter->x2 = filter->x1;
+    filter->x1 = in;
+    filter->y2 = filter->y1;
+    filter->y1 = out;
+
+    return out;
+}
+
+// Q31 x Q(31-s) products use up to 62 bits, so each one is rounded down by 16
+// bits before summing to keep five of them inside the 64-bit accumulator
+static inline int64_t product_q31(int32_t coeff, int32_t sample) {
+    return ((int64_t)coeff * sample + (1 << 15)) >> 16;
+}
+
+int32_t biquad_process_q31(BiquadQ31* filter, int32_t in) {
+    int shift = 15 - filter->coeff_shift;
+    int64_t accum = product_q31(filter->b0, in);
+    accum = add_saturate(accum, product_q31(filter->b1, filter->x1));
+    accum = add_saturate(accum, product_q31(filter->b2, filter->x2));
+    accum = add_saturate(accum, -product_q31(filter->a1, filter->y1));
+    accum = add_saturate(accum, -product_q31(filter->a2, filter->y2));
+    int32_t out = (int32_t)round_shift_saturate(accum, shift, INT32_MIN, INT32_MAX);
+
+    filter->x2 = filter->x1;
+    filter->x1 = in;
+    filter->y2 = filter->y1;
+    filter->y1 = out;
+
+    return out;
+}
+
+void process_chunk_q15(const int16_t* input_chunk, int16_t* output_chunk, size_t nSamples, BiquadQ15* filters, size_t num_filters) {
+    for (size_t i = 0; i < nSamples; ++i) {
+        int16_t sample = input_chunk[i];
+        for (size_t j = 0; j < num_filters; ++j) {
+            sample = biquad_process_q15(&filters[j], sample);
+        }
+        output_chunk[i] = sample;
+    }
+}
+
+void process_chunk_q31(const int32_t* input_chunk, int32_t* output_chunk, size_t nSamples, BiquadQ31* filters, size_t num_filters) {
+    for (size_t i = 0; i < nSamples; ++i) {
+        int32_t sample = input_chunk[i];
+        for (size_t j = 0; j < num_filters; ++j) {
+            sample = biquad_process_q31(&filters[j], sample);
+        }
+        output_chunk[i] = sample;
+    }
+}
+
+int16_t double_to_q15(double value, double full_scale) {
+    return (int16_t)quantize(value / full_scale, 15, QUANT_ROUND, INT16_MIN, INT16_MAX);
+}
+
+int32_t double_to_q31(double value, double full_scale) {
+    return (int32_t)quantize(value / full_scale, 31, QUANT_ROUND, INT32_MIN, INT32_MAX);
+}
+
+double q15_to_double(int16_t value, double full_scale) {
+    return ldexp((double)value, -15) * full_scale;
+}
+
+double q31_to_double(int32_t value, double full_scale) {
+    return ldexp((double)value, -31) * full_scale;
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/data.h"
+#include "../include/iir.h"
+#include "../include/iir_fixed.h"
+
+int main(int argc, char *argv[]) {
+    if (argc != 9) {
+        fprintf(stderr, "Usage: %s <input csv file> <output csv file> <IIR coeffs file> <num IIR filters> <buffer size> <q15|q31> <round|truncate> <full scale>\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *inputFileName = argv[1];
+    char *outputFileName = argv[2];
+    char *iirCoeffsFile = argv[3];
+    int numIIRFilters = atoi(argv[4]);
+    int nChunk = atoi(argv[5]);
+    bool useQ31 = strcmp(argv[6], "q31") == 0;
+    quant_mode mode = strcmp(argv[7], "truncate") == 0 ? QUANT_TRUNCATE : QUANT_ROUND;
+    double fullScale = atof(argv[8]);
+    if ((!useQ31 && strcmp(argv[6], "q15") != 0) || (mode == QUANT_ROUND && strcmp(argv[7], "round") != 0)) {
+        fprintf(stderr, "Invalid format. Use 'q15' or 'q31' and 'round' or 'truncate'.\n");
+        return 1;
+    }
+    if (numIIRFilters <= 0 || nChunk <= 0 || fullScale <= 0.0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    FILE *inputFile = fopen(inputFileName, "r");
+    if (inputFile == NULL) {
+        fprintf(stderr, "Can't open input file!\n");
+        return -1;
+    }
+
+    FILE *outputFile = fopen(outputFileName, "w");
+    if (outputFile == NULL) {
+        fprintf(stderr, "Can't open output file!\n");
+        fclose(inputFile);
+        return -1;
+    }
+
+    Biquad *iirCoeffs = (Biquad*)calloc(numIIRFilters, sizeof(Biquad));
+    BiquadQ15 *filtersQ15 = (BiquadQ15*)calloc(numIIRFilters, sizeof(BiquadQ15));
+    BiquadQ31 *filtersQ31 = (BiquadQ31*)calloc(numIIRFilters, sizeof(BiquadQ31));
+    double *inputChunk = (double*)calloc(nChunk, sizeof(double));
+    double *referenceChunk = (double*)calloc(nChunk, sizeof(double));
+    double *outputChunk = (double*)calloc(nChunk, sizeof(double));
+    int16_t *samplesQ15 = (int16_t*)calloc(nChunk, sizeof(int16_t));
+    int32_t *samplesQ31 = (int32_t*)calloc(nChunk, sizeof(int32_t));
+
+    if (!iirCoeffs || !filtersQ15 || !filtersQ31 || !inputChunk || !referenceChunk || !outputChunk ||
+        !samplesQ15 || !samplesQ31) {
+        fprintf(stderr, "Failed to allocate memory\n");
+    } else {
+        // Read IIR filter coefficients, the double cascade is the reference
+        load_biquad_coefficients(iirCoeffsFile, iirCoeffs, numIIRFilters);
+        for (int i = 0; i < numIIRFilters; i++) {
+            if (useQ31) {
+                biquad_init_q31(&filtersQ31[i], &iirCoeffs[i], mode);
+            } else {
+                biquad_init_q15(&filtersQ15[i], &iirCoeffs[i], mode);
+            }
+        }
+
+        double signalEnergy = 0.0;
+        double errorEnergy = 0.0;
+        double maxError = 0.0;
+        int num_read = 0;
+
+        // Process the same chunks with both cascades
+        while ((num_read = read_chunk(inputFile, inputChunk, nChunk)) > 0) {
+            process_chunk(inputChunk, referenceChunk, num_read, iirCoeffs, numIIRFilters);
+
+            if (useQ31) {
+                for (int i = 0; i < num_read; i++) {
+                    samplesQ31[i] = double_to_q31(inputChunk[i], fullScale);
+                }
+                process_chunk_q31(samplesQ31, samplesQ31, num_read, filtersQ31, numIIRFilters);
+                for (int i = 0; i < num_read; i++) {
+                    outputChunk[i] = q31_to_double(samplesQ31[i], fullScale);
+                }
+            } else {
+                for (int i = 0; i < num_read; i++) {
+                    samplesQ15[i] = double_to_q15(inputChunk[i], fullScale);
+                }
+                process_chunk_q15(samplesQ15, samplesQ15, num_read, filtersQ15, numIIRFilters);
+                for (int i = 0; i < num_read; i++) {
+                    outputChunk[i] = q15_to_double(samplesQ15[i], fullScale);
+                }
+            }
+
+            for (int i = 0; i < num_read; i++) {
+                double error = outputChunk[i] - referenceChunk[i];
+                signalEnergy += referenceChunk[i] * referenceChunk[i];
+                errorEnergy += error * error;
+                maxError = fmax(maxError, fabs(error));
+            }
+            write_chunk(outputFile, outputChunk, num_read);
+        }
+
+        printf("%s, %s coefficients, full scale %g\n", useQ31 ? "Q31" : "Q15",
+               mode == QUANT_ROUND ? "rounded" : "truncated", fullScale);
+        printf("SNR against double reference: %.2f dB, max abs error %.3g\n",
+               errorEnergy > 0.0 ? 10.0 * log10(signalEnergy / errorEnergy) : INFINITY, maxError);
+    }
+
+    // Free memory and close files
+    free(iirCoeffs);
+    free(filtersQ15);
+    free(filtersQ31);
+    free(inputChunk);
+    free(referenceChunk);
+    free(outputChunk);
+    free(samplesQ15);
+    free(samplesQ31);
+    fclose(inputFile);
+    fclose(outputFile);
+    return 0;
+}
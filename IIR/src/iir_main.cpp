@@ -3,6 +3,9 @@
 #include <string.h>
 #include "../include/data.h"
 #include "../include/iir.h"
+#include "../include/iir_cascade.h"
+#include "../include/iir_block.h"
+#include "../include/denormal.h"
 
 // Function prototype for cleanup
 void cleanup(Biquad *coeffs, double *inputChunk, double *outputChunk, FILE *inputFile, FILE *outputFile);
@@ -17,8 +20,8 @@ void cleanup(Biquad *coeffs, double *inputChunk, double *outputChunk, FILE *inpu
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 6) {
-        fprintf(stderr, "Usage: %s <input csv file> <output csv file> <IIR coeffs file> <num IIR filters> <buffer size>\n", argv[0]);
+    if (argc < 6 || argc > 9) {
+        fprintf(stderr, "Usage: %s <input csv file> <output csv file> <IIR coeffs file> <num IIR filters> <buffer size> [direct|tdf2|tdf2f|block4|block8] [ftz] [count]\n", argv[0]);
         return 1;
     }
 
@@ -28,6 +31,27 @@ int main(int argc, char *argv[]) {
     char *iirCoeffsFile = argv[3];
     int numIIRFilters = atoi(argv[4]);
     int nChunk = atoi(argv[5]);
+    const char *engine = "direct";
+    bool flushToZero = false;
+    bool countDenormals = false;
+    for (int i = 6; i < argc; i++) {
+        if (strcmp(argv[i], "ftz") == 0) {
+            flushToZero = true;
+        } else if (strcmp(argv[i], "count") == 0) {
+            countDenormals = true;
+        } else if (strcmp(argv[i], "direct") == 0 || strcmp(argv[i], "tdf2") == 0 || strcmp(argv[i], "tdf2f") == 0 ||
+                   strcmp(argv[i], "block4") == 0 || strcmp(argv[i], "block8") == 0) {
+            engine = argv[i];
+        } else {
+            fprintf(stderr, "Invalid engine. Use 'direct', 'tdf2', 'tdf2f', 'block4' or 'block8', then 'ftz' and 'count'.\n");
+            return 1;
+        }
+    }
+
+    // Decaying states of the high-Q stages go subnormal once the input is silent
+    if (flushToZero && !enable_flush_to_zero()) {
+        fprintf(stderr, "Flush-to-zero is not supported on this target, continuing without it\n");
+    }
 
     // Initialize data arrays
     FILE *inputFile = fopen(inputFileName, "r");
@@ -46,10 +70,14 @@ int main(int argc, char *argv[]) {
     Biquad *iirCoeffs = (Biquad*)malloc(numIIRFilters * sizeof(Biquad));
     double *inputChunk = (double*)malloc(nChunk * sizeof(double));
     double *outputChunk = (double*)malloc(nChunk * sizeof(double));
+    // Subnormal counts per stage for the current chunk and for the whole run
+    long *stageCounts = (long*)calloc(2 * numIIRFilters, sizeof(long));
+    long *stageTotals = stageCounts + numIIRFilters;
 
     // Check memory allocation
-    if (!iirCoeffs || !inputChunk || !outputChunk) {
+    if (!iirCoeffs || !inputChunk || !outputChunk || !stageCounts) {
         fprintf(stderr, "Failed to allocate memory\n");
+        free(stageCounts);
         cleanup(iirCoeffs, inputChunk, outputChunk, inputFile, outputFile);
         return -1;
     }
@@ -62,14 +90,83 @@ int main(int argc, char *argv[]) {
     // Read IIR filter coefficients
     load_biquad_coefficients(iirCoeffsFile, iirCoeffs, numIIRFilters);
 
+    // Block engines: double or float TDF-II cascade, up to four stages per pass over the chunk
+    BiquadCascade cascade = {};
+    BiquadCascadeF cascadeF = {};
+    BiquadBlock block = {};
+    float *floatChunk = NULL;
+    int status = 0;
+    if (strcmp(engine, "tdf2") == 0) {
+        status = cascade_init(&cascade, iirCoeffs, numIIRFilters);
+    } else if (strcmp(engine, "tdf2f") == 0) {
+        status = cascade_init_f(&cascadeF, iirCoeffs, numIIRFilters);
+        floatChunk = (float*)malloc(nChunk * sizeof(float));
+        status = (status == 0 && floatChunk) ? 0 : -1;
+    } else if (strncmp(engine, "block", 5) == 0) {
+        // Look-ahead state space, 4 or 8 outputs per step
+        status = block_init(&block, iirCoeffs, numIIRFilters, atoi(engine + 5));
+    }
+    if (status != 0) {
+        fprintf(stderr, "Failed to allocate memory\n");
+    }
+
     int num_read = 0;
+    int chunkIndex = 0;
     // Process audio file in chunks
-    while ((num_read = read_chunk(inputFile, inputChunk, nChunk)) > 0) {
-        process_chunk(inputChunk, outputChunk, num_read, iirCoeffs, numIIRFilters);
+    while (status == 0 && (num_read = read_chunk(inputFile, inputChunk, nChunk)) > 0) {
+        if (countDenormals && !cascade.coeffs && !block.matrices && !cascadeF.coeffs) {
+            process_chunk_counted(inputChunk, outputChunk, num_read, iirCoeffs, numIIRFilters, stageCounts);
+        } else if (cascade.coeffs) {
+            cascade_process(&cascade, inputChunk, outputChunk, num_read);
+        } else if (block.matrices) {
+            block_process(&block, inputChunk, outputChunk, num_read);
+        } else if (cascadeF.coeffs) {
+            for (int i = 0; i < num_read; i++) {
+                floatChunk[i] = (float)inputChunk[i];
+            }
+            cascade_process_f(&cascadeF, floatChunk, floatChunk, num_read);
+            for (int i = 0; i < num_read; i++) {
+                outputChunk[i] = floatChunk[i];
+            }
+        } else {
+            process_chunk(inputChunk, outputChunk, num_read, iirCoeffs, numIIRFilters);
+        }
         write_chunk(outputFile, outputChunk, num_read);
+
+        // The block engines keep every stage output inside the chunk, for them the
+        // two state values each stage carries into the next chunk are checked instead
+        if (countDenormals) {
+            for (int j = 0; j < numIIRFilters; j++) {
+                if (cascade.coeffs) {
+                    stageCounts[j] = count_subnormals(&cascade.state[2 * j], 2);
+                } else if (block.matrices) {
+                    stageCounts[j] = count_subnormals(&block.state[2 * j], 2);
+                } else if (cascadeF.coeffs) {
+                    stageCounts[j] = count_subnormals_f(&cascadeF.state[2 * j], 2);
+                }
+                if (stageCounts[j] > 0) {
+                    printf("chunk %d: stage %d: %ld subnormal values\n", chunkIndex, j, stageCounts[j]);
+                }
+                stageTotals[j] += stageCounts[j];
+                stageCounts[j] = 0;
+            }
+        }
+        chunkIndex++;
+    }
+    if (countDenormals) {
+        long total = 0;
+        for (int j = 0; j < numIIRFilters; j++) {
+            total += stageTotals[j];
+        }
+        printf("%d chunks: %ld subnormal values\n", chunkIndex, total);
     }
+    free(stageCounts);
+    cascade_free(&cascade);
+    cascade_free_f(&cascadeF);
+    block_free(&block);
+    free(floatChunk);
 
     // Free memory and close files
     cleanup(iirCoeffs, inputChunk, outputChunk, inputFile, outputFile);
-    return 0;
+    return status;
 }
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/data.h"
+#include "../include/iir_multichannel.h"
+
+int main(int argc, char *argv[]) {
+    if (argc != 7 && argc != 8) {
+        fprintf(stderr, "Usage: %s <input csv file> <output csv file> <IIR coeffs file> <num IIR filters> <buffer size> <num channels> [lanes 4|8|16]\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *inputFileName = argv[1];
+    char *outputFileName = argv[2];
+    char *iirCoeffsFile = argv[3];
+    int numIIRFilters = atoi(argv[4]);
+    int nChunk = atoi(argv[5]);
+    int numChannels = atoi(argv[6]);
+    int lanes = (argc == 8) ? atoi(argv[7]) : 8;
+    if (numIIRFilters <= 0 || nChunk <= 0 || numChannels <= 0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+    if (lanes != 4 && lanes != 8 && lanes != 16) {
+        fprintf(stderr, "Invalid lane count. Use 4, 8 or 16.\n");
+        return 1;
+    }
+
+    FILE *inputFile = fopen(inputFileName, "r");
+    if (inputFile == NULL) {
+        fprintf(stderr, "Can't open input file!\n");
+        return -1;
+    }
+
+    FILE *outputFile = fopen(outputFileName, "w");
+    if (outputFile == NULL) {
+        fprintf(stderr, "Can't open output file!\n");
+        fclose(inputFile);
+        return -1;
+    }
+
+    Biquad *iirCoeffs = (Biquad*)calloc(numIIRFilters, sizeof(Biquad));
+    double *frames = (double*)malloc((size_t)nChunk * numChannels * sizeof(double));
+    BiquadMulti multi = {};
+    int status = -1;
+
+    if (!iirCoeffs || !frames) {
+        fprintf(stderr, "Failed to allocate memory\n");
+    } else {
+        // Read IIR filter coefficients, every channel runs the same cascade
+        load_biquad_coefficients(iirCoeffsFile, iirCoeffs, numIIRFilters);
+        if (multi_init(&multi, iirCoeffs, numIIRFilters, numChannels, lanes, nChunk) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+        } else {
+            printf("%d channels in %d groups of %d lanes, %s kernel\n", numChannels, multi.num_groups, lanes,
+                   multi.kernel_name);
+
+            // Process the file in chunks of frames, filtered in place
+            int num_read = 0;
+            while ((num_read = read_frames(inputFile, frames, numChannels, nChunk)) > 0) {
+                process_multichannel(&multi, frames, frames, num_read);
+                write_frames(outputFile, frames, numChannels, num_read);
+            }
+            status = 0;
+        }
+    }
+
+    // Free memory and close files
+    multi_free(&multi);
+    free(iirCoeffs);
+    free(frames);
+    fclose(inputFile);
+    fclose(outputFile);
+    return status;
+}
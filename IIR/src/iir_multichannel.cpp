@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/iir_multichannel.h"
+
+// A group of stages over the chunk for W lanes, TDF-II per stage as in iir_cascade.cpp.
+// The vector type spans W doubles, the compiler splits it into as many registers as the
+// target needs, which also gives several independent recurrences per stage.
+template <int W, int GROUP>
+__attribute__((always_inline)) inline void multi_stages(const double* coeffs, double* state, double* work, int num_frames) {
+    typedef double vec __attribute__((vector_size(W * sizeof(double))));
+    double b0[GROUP], b1[GROUP], b2[GROUP], a1[GROUP], a2[GROUP];
+    vec s1[GROUP], s2[GROUP];
+    for (int g = 0; g < GROUP; ++g) {
+        b0[g] = coeffs[5 * g + 0];
+        b1[g] = coeffs[5 * g + 1];
+        b2[g] = coeffs[5 * g + 2];
+        a1[g] = coeffs[5 * g + 3];
+        a2[g] = coeffs[5 * g + 4];
+        memcpy(&s1[g], &state[(2 * g + 0) * W], sizeof(vec));
+        memcpy(&s2[g], &state[(2 * g + 1) * W], sizeof(vec));
+    }
+    for (int n = 0; n < num_frames; ++n) {
+        vec x;
+        memcpy(&x, &work[n * W], sizeof(vec));
+        for (int g = 0; g < GROUP; ++g) {
+            vec y = b0[g] * x + s1[g];
+            s1[g] = b1[g] * x - a1[g] * y + s2[g];
+            s2[g] = b2[g] * x - a2[g] * y;
+            x = y;
+        }
+        memcpy(&work[n * W], &x, sizeof(vec));
+    }
+    for (int g = 0; g < GROUP; ++g) {
+        memcpy(&state[(2 * g + 0) * W], &s1[g], sizeof(vec));
+        memcpy(&state[(2 * g + 1) * W], &s2[g], sizeof(vec));
+    }
+}
+
+// All stages, four per pass over the chunk
+template <int W>
+__attribute__((always_inline)) inline void multi_group(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    size_t j = 0;
+    for (; j + 4 <= num_stages; j += 4) {
+        multi_stages<W, 4>(&coeffs[5 * j], &state[2 * W * j], work, num_frames);
+    }
+    for (; j < num_stages; ++j) {
+        multi_stages<W, 1>(&coeffs[5 * j], &state[2 * W * j], work, num_frames);
+    }
+}
+
+// Baseline instruction set
+static void multi_group_4(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<4>(coeffs, state, num_stages, work, num_frames);
+}
+
+static void multi_group_8(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<8>(coeffs, state, num_stages, work, num_frames);
+}
+
+static void multi_group_16(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<16>(coeffs, state, num_stages, work, num_frames);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// AVX2: one (W=4) to four (W=16) ymm registers per vector
+__attribute__((target("avx2,fma")))
+static void multi_group_4_avx2(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<4>(coeffs, state, num_stages, work, num_frames);
+}
+
+__attribute__((target("avx2,fma")))
+static void multi_group_8_avx2(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<8>(coeffs, state, num_stages, work, num_frames);
+}
+
+__attribute__((target("avx2,fma")))
+static void multi_group_16_avx2(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<16>(coeffs, state, num_stages, work, num_frames);
+}
+
+// AVX-512: 8 doubles per zmm register
+__attribute__((target("avx512f")))
+static void multi_group_8_avx512(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<8>(coeffs, state, num_stages, work, num_frames);
+}
+
+__attribute__((target("avx512f")))
+static void multi_group_16_avx512(const double* coeffs, double* state, size_t num_stages, double* work, int num_frames) {
+    multi_group<16>(coeffs, state, num_stages, work, num_frames);
+}
+#endif
+
+// Widest instruction set the host supports for the lane count
+static MultiGroupKernel select_kernel(int width, const char** name) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (width >= 8 && __builtin_cpu_supports("avx512f")) {
+        *name = "avx512";
+        return (width == 8) ? multi_group_8_avx512 : multi_group_16_avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        *name = "avx2";
+        return (width == 4) ? multi_group_4_avx2 : (width == 8) ? multi_group_8_avx2 : multi_group_16_avx2;
+    }
+#endif
+    *name = "generic";
+    return (width == 4) ? multi_group_4 : (width == 8) ? multi_group_8 : multi_group_16;
+}
+
+int multi_init(BiquadMulti* multi, const Biquad* filters, size_t num_filters, int num_channels, int width, int max_frames) {
+    if (num_filters == 0 || num_channels <= 0 || max_frames <= 0 || (width != 4 && width != 8 && width != 16)) {
+        return -1;
+    }
+    multi->num_stages = num_filters;
+    multi->num_channels = num_channels;
+    multi->width = width;
+    multi->num_groups = (num_channels + width - 1) / width;
+    multi->max_frames = max_frames;
+    multi->coeffs = (double*)malloc(5 * num_filters * sizeof(double));
+    multi->state = (double*)calloc((size_t)multi->num_groups * num_filters * 2 * width, sizeof(double));
+    multi->work = (double*)malloc((size_t)max_frames * width * sizeof(double));
+    multi->kernel = select_kernel(width, &multi->kernel_name);
+    if (!multi->coeffs || !multi->state || !multi->work) {
+        multi_free(multi);
+        return -1;
+    }
+
+    for (size_t j = 0; j < num_filters; ++j) {
+        multi->coeffs[5 * j + 0] = filters[j].b0;
+        multi->coeffs[5 * j + 1] = filters[j].b1;
+        multi->coeffs[5 * j + 2] = filters[j].b2;
+        multi->coeffs[5 * j + 3] = filters[j].a1;
+        multi->coeffs[5 * j + 4] = filters[j].a2;
+    }
+    return 0;
+}
+
+void multi_free(BiquadMulti* multi) {
+    free(multi->coeffs);
+    free(multi->state);
+    free(multi->work);
+    multi->coeffs = NULL;
+    multi->state = NULL;
+    multi->work = NULL;
+}
+
+// Each group is copied into the work buffer, filtered there and copied back.
+// The last group is padded with silent lanes when the channel count is not a multiple of the width.
+void process_multichannel(BiquadMulti* multi, const double* input, double* output, int num_frames) {
+    int num_channels = multi->num_channels;
+    int width = multi->width;
+    double* work = multi->work;
+
+    for (int start = 0; start < num_frames; start += multi->max_frames) {
+        int frames = (num_frames - start < multi->max_frames) ? num_frames - start : multi->max_frames;
+        const double* in = input + (size_t)start * num_channels;
+        double* out = output + (size_t)start * num_channels;
+
+        for (int group = 0; group < multi->num_groups; ++group) {
+            int first = group * width;
+            int lanes = (num_channels - first < width) ? num_channels - first : width;
+
+            for (int n = 0; n < frames; ++n) {
+                memcpy(&work[n * width], &in[(size_t)n * num_channels + first], lanes * sizeof(double));
+                for (int l = lanes; l < width; ++l) {
+                    work[n * width + l] = 0.0;
+                }
+            }
+            multi->kernel(multi->coeffs, &multi->state[(size_t)group * multi->num_stages * 2 * width],
+                          multi->num_stages, work, frames);
+            for (int n = 0; n < frames; ++n) {
+                memcpy(&out[(size_t)n * num_channels + first], &work[n * width], lanes * sizeof(double));
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef FFT_H
+#define FFT_H
+
+// Structure to represent a complex number
+typedef struct {
+    float real;
+    float imag;
+} Complex;
+
+// Precomputed tables for a real-input FFT of length size (power of two, >= 4).
+// The transform runs as a complex FFT of size/2 points plus a split step.
+typedef struct {
+    int size;
+    Complex *twiddles;   // exp(-j*2*pi*k/size), k < size/2
+    int *bitReverse;     // permutation for the size/2 point complex FFT
+} FFTPlan;
+
+// Allocate the tables. Returns 0 on success, -1 on failure or if size is not a power of two.
+int fftInit(FFTPlan *plan, int size);
+
+void fftFree(FFTPlan *plan);
+
+// In-place complex FFT of plan->size/2 points (unscaled)
+void fftComplex(const FFTPlan *plan, Complex *data, bool inverse);
+
+// Real input of plan->size samples to plan->size/2+1 spectrum bins
+void fftRealForward(const FFTPlan *plan, const float *input, Complex *spectrum);
+
+// plan->size/2+1 spectrum bins to plan->size real samples, scaled by 1/size.
+// The spectrum is used as scratch memory and overwritten.
+void fftRealInverse(const FFTPlan *plan, Complex *spectrum, float *output);
+
+// Smallest power of two >= n
+int fftNextPow2(int n);
+
+#endif
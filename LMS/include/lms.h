@@ -2,9 +2,62 @@
 #define LMS_H
 
 #include <string.h>
+#include "lmsKernels.h"
 
-void processLMS(float *inputChunk, float *outputChunk, float *adaptiveCoeffs,
-                          int numSamples, int numLMSCoeffs, float mu, float interfererFreq,
-                          float sampleRate);
+// Recursive sinusoid oscillator, a unit phasor rotated once per sample
+typedef struct {
+    double cos, sin;         // phasor at the current phase of the reference
+    double rotCos, rotSin;   // rotation by one phase increment
+} LMSOscillator;
 
-#endif
\ No newline at end of file
+// Adaptive canceller for one or more sinusoidal interferers. Every tone has its own
+// oscillator, delay line and coefficients (a bank of adaptive notches). The estimates of
+// all tones are summed and share one error signal, so the bank cancels every tone in a
+// single pass over the input.
+//
+// Each reference sinusoid comes from its oscillator, one new value per sample, and is
+// kept in a delay line of numLMSCoeffs + 1 values that is stored twice back to back
+// (mirrored), newest value first. The last numLMSCoeffs + 1 reference values are then
+// always the contiguous window reference[referenceIndex .. referenceIndex+numLMSCoeffs],
+// which holds the reference of the current and of the previous sample. The fused kernel
+// applies the update of the previous sample and computes the output of the current one
+// in the same pass.
+//
+// With normalized set, the step is mu * error / (||x||^2 + eps) (NLMS) with the power of
+// all reference windows, stable for 0 < mu < 2 whatever the reference power. Otherwise it
+// is the plain LMS step 2 * mu * error.
+typedef struct {
+    float *adaptiveCoeffs;   // numLMSCoeffs per tone, tone after tone, owned
+    int numLMSCoeffs;
+    int numTones;
+    float mu;
+    bool normalized;         // NLMS step size, false after lmsInit
+    float *reference;        // per tone a mirrored delay line of 2*(numLMSCoeffs+1) values, owned
+    int referenceIndex;      // shared, all delay lines advance together
+    LMSOscillator *oscillators;  // numTones, owned
+    LMSFusedKernel fused;    // selected for the host CPU in lmsInit
+} LMSFilter;
+
+// Allocate zeroed coefficients and fill the delay lines with the reference values before
+// phase zero, so the first samples see the same history as a continuous sinusoid.
+// For an external reference (processLMSReference) use interfererFreq 0, the delay line
+// then starts silent. Returns 0 on success, -1 on failure.
+int lmsInit(LMSFilter *filter, int numLMSCoeffs, float mu, float interfererFreq, float sampleRate);
+
+// Same for numTones interferers at interfererFreqs
+int lmsInitMultiTone(LMSFilter *filter, int numLMSCoeffs, float mu, const float *interfererFreqs, int numTones,
+                     float sampleRate);
+
+// Release coefficients, delay lines and oscillators
+void lmsFree(LMSFilter *filter);
+
+// Cancel the interferers in one chunk, the output is the error signal.
+// Coefficients, delay lines and oscillators are carried over to the next call.
+void processLMS(LMSFilter *filter, const float *inputChunk, float *outputChunk, int numSamples);
+
+// Adaptive noise cancellation from a recorded reference, e.g. a second microphone. The
+// reference samples go into the delay line of the first tone instead of its oscillator.
+void processLMSReference(LMSFilter *filter, const float *referenceChunk, const float *inputChunk, float *outputChunk,
+                         int numSamples);
+
+#endif
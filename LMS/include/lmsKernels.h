@@ -0,0 +1,30 @@
+#ifndef LMS_KERNELS_H
+#define LMS_KERNELS_H
+
+// One fused LMS step over a reference window of numLMSCoeffs + 1 values, newest first.
+// window[1..N] is the reference of the previous sample and window[0..N-1] the one of
+// the current sample. The kernel adds step * window[k+1] to coefficient k (update for
+// the previous error) and returns the dot product of the updated coefficients with
+// window[0..N-1] (filter output for the current sample), in one pass over the arrays.
+typedef float (*LMSFusedKernel)(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs);
+
+typedef struct {
+    const char *name;
+    LMSFusedKernel fused;
+} LMSKernelInfo;
+
+// Portable reference kernel
+float lmsFusedScalar(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs);
+
+#if defined(__x86_64__) || defined(__i386__)
+float lmsFusedAVX2(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs);
+float lmsFusedAVX512(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs);
+#endif
+
+// List the kernels the host CPU can run, fastest last. Returns the number of entries.
+int lmsAvailableKernels(LMSKernelInfo *kernels, int maxKernels);
+
+// Fastest kernel for the tap count and host CPU
+LMSKernelInfo lmsSelectKernel(int numLMSCoeffs);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef LMS_SNAPSHOT_H
+#define LMS_SNAPSHOT_H
+
+#include "lms.h"
+
+// Binary snapshot of the adapted state of an LMSFilter: coefficients, oscillator phasors,
+// delay lines and their position. A later run on the same site loads it and starts
+// converged instead of from zero coefficients.
+//
+// Layout, native byte order: a header (magic "LMSS", version, numLMSCoeffs, numTones,
+// referenceIndex as int32), numTones LMSOscillator, numTones * numLMSCoeffs coefficients
+// and numTones * 2 * (numLMSCoeffs + 1) delay line values as float.
+
+// Write the snapshot to path. It goes to path.tmp first and is then renamed over path,
+// so a crash while saving leaves the previous snapshot intact. Returns 0 on success,
+// -1 on failure.
+int lmsSaveSnapshot(const LMSFilter *filter, const char *path);
+
+// Load a snapshot into a filter from lmsInit / lmsInitMultiTone. The tap count, the
+// number of tones and the oscillator frequencies must match the filter. Returns 0 on
+// success, 1 if path does not exist and -1 if it cannot be used. The filter is only
+// changed on success.
+int lmsLoadSnapshot(LMSFilter *filter, const char *path);
+
+#endif
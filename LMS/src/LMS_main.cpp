@@ -1,23 +1,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <sndfile.h>
 #include <math.h>
 #include "../include/lms.h"
+#include "../include/lmsBlock.h"
+#include "../include/lmsSnapshot.h"
+#include "../include/denormal.h"
 
 // Cleanup function
-void cleanup(float *adaptiveCoeffs, float *inputChunk, float *outputChunk, SNDFILE *infile, SNDFILE *outfile) {
-    free(adaptiveCoeffs);
+void cleanup(LMSFilter *filter, LMSBlockFilter *blockFilter, float *inputChunk, float *outputChunk, float *frameChunk,
+             SNDFILE *infile, SNDFILE *outfile) {
+    if (filter) lmsFree(filter);
+    if (blockFilter) lmsBlockFree(blockFilter);
     free(inputChunk);
     free(outputChunk);
+    free(frameChunk);
     if (infile) sf_close(infile);
     if (outfile) sf_close(outfile);
 }
 
 int main(int argc, char *argv[]) {
-    // Expecting 7 arguments
-    if (argc != 7) {
-        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <num FIR coeffs> <buffer size> <learning rate (mu)> <interferer frequency>\n", argv[0]);
+    // Expecting 7 arguments, optionally followed by ref <channel>, snapshot <file> <every chunks>,
+    // block, nlms, ftz and count. With ref the reference is that input channel and the
+    // interferer frequencies are ignored.
+    if (argc < 7 || argc > 16) {
+        fprintf(stderr, "Usage: %s <input wav file> <output wav file> <num FIR coeffs> <buffer size> <learning rate (mu)> <interferer frequencies, comma separated> [ref <channel>] [snapshot <file> <every chunks>] [block] [nlms] [ftz] [count]\n", argv[0]);
         return 1;
     }
 
@@ -27,26 +36,110 @@ int main(int argc, char *argv[]) {
     int numLMSCoeffs = atoi(argv[3]);
     int nSamples = atoi(argv[4]);
     float mu = atof(argv[5]);
-    float interfererFreq = atof(argv[6]);
+
+    // One adaptive notch per interferer frequency, all of them in the same pass
+    int numTones = 1;
+    for (const char *c = argv[6]; *c; c++) {
+        numTones += (*c == ',') ? 1 : 0;
+    }
+    float *interfererFreqs = (float *)malloc(numTones * sizeof(float));
+    if (!interfererFreqs) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return -1;
+    }
+    char *token = argv[6];
+    for (int t = 0; t < numTones; t++) {
+        char *end;
+        interfererFreqs[t] = strtof(token, &end);
+        if (end == token || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Invalid interferer frequency list: %s\n", argv[6]);
+            free(interfererFreqs);
+            return 1;
+        }
+        token = end + 1;
+    }
+    int referenceChannel = -1;
+    const char *snapshotFile = NULL;
+    int snapshotInterval = 0;
+    bool useBlock = false;
+    bool normalized = false;
+    bool flushToZero = false;
+    bool countDenormals = false;
+    for (int i = 7; i < argc; i++) {
+        // The channel is checked against the file once it is open
+        if (strcmp(argv[i], "ref") == 0 && i + 1 < argc) {
+            char *end;
+            long value = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || value < 0 || value > INT_MAX) {
+                fprintf(stderr, "Invalid reference channel %s. Use 'ref <channel>' with a channel index >= 0.\n", argv[i]);
+                free(interfererFreqs);
+                return 1;
+            }
+            referenceChannel = (int)value;
+        } else if (strcmp(argv[i], "snapshot") == 0 && i + 2 < argc) {
+            snapshotFile = argv[++i];
+            char *end;
+            long value = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || value <= 0 || value > INT_MAX) {
+                fprintf(stderr, "Invalid snapshot interval %s. Use 'snapshot <file> <every chunks>' with a positive number of chunks.\n", argv[i]);
+                free(interfererFreqs);
+                return 1;
+            }
+            snapshotInterval = (int)value;
+        } else if (strcmp(argv[i], "block") == 0) {
+            useBlock = true;
+        } else if (strcmp(argv[i], "nlms") == 0) {
+            normalized = true;
+        } else if (strcmp(argv[i], "ftz") == 0) {
+            flushToZero = true;
+        } else if (strcmp(argv[i], "count") == 0) {
+            countDenormals = true;
+        } else {
+            fprintf(stderr, "Invalid option %s. Use 'ref <channel>', 'snapshot <file> <every chunks>', 'block', 'nlms', 'ftz' and 'count'.\n", argv[i]);
+            free(interfererFreqs);
+            return 1;
+        }
+    }
+    if (snapshotFile && (snapshotInterval <= 0 || useBlock)) {
+        fprintf(stderr, "Snapshots need a positive chunk interval and the time-domain filter\n");
+        free(interfererFreqs);
+        return 1;
+    }
+    if (referenceChannel >= 0) {
+        // One filter driven by the recorded reference, no oscillators
+        numTones = 1;
+        interfererFreqs[0] = 0.0f;
+    } else if (useBlock && numTones > 1) {
+        fprintf(stderr, "The block engine takes one interferer frequency\n");
+        free(interfererFreqs);
+        return 1;
+    }
+
+    // With a silent input the adaptive coefficients leak towards zero and go subnormal
+    if (flushToZero && !enableFlushToZero()) {
+        fprintf(stderr, "Flush-to-zero is not supported on this target, continuing without it\n");
+    }
 
     // Initialize data arrays
-    float *adaptiveCoeffs = (float *)malloc(numLMSCoeffs * sizeof(float));
+    LMSFilter filter = {};
+    LMSBlockFilter blockFilter = {};
     float *inputChunk = (float *)malloc(nSamples * sizeof(float));
     float *outputChunk = (float *)malloc(nSamples * sizeof(float));
+    float *frameChunk = NULL;
     SNDFILE *infile = NULL;
     SNDFILE *outfile = NULL;
     SF_INFO sfinfo;
     sf_count_t num_read;
 
     // Check memory allocation
-    if (!adaptiveCoeffs || !inputChunk || !outputChunk) {
+    if (!inputChunk || !outputChunk) {
         fprintf(stderr, "Failed to allocate memory\n");
-        cleanup(adaptiveCoeffs, inputChunk, outputChunk, NULL, NULL);
+        free(interfererFreqs);
+        cleanup(NULL, NULL, inputChunk, outputChunk, NULL, NULL, NULL);
         return -1;
     }
 
     // Initialize arrays to zero
-    memset(adaptiveCoeffs, 0, numLMSCoeffs * sizeof(float));  // Start with zero coefficients   
     memset(inputChunk, 0, nSamples * sizeof(float));
     memset(outputChunk, 0, nSamples * sizeof(float));
 
@@ -54,25 +147,115 @@ int main(int argc, char *argv[]) {
     infile = sf_open(inputFile, SFM_READ, &sfinfo);
     if (!infile) {
         fprintf(stderr, "Could not open input file: %s\n", inputFile);
-        cleanup(adaptiveCoeffs, inputChunk, outputChunk, infile, NULL);
+        free(interfererFreqs);
+        cleanup(NULL, NULL, inputChunk, outputChunk, frameChunk, infile, NULL);
+        return -1;
+    }
+
+    // Interleaved frames of all channels, followed by the deinterleaved reference
+    SF_INFO outinfo = sfinfo;
+    if (referenceChannel >= 0) {
+        if (sfinfo.channels < 2 || referenceChannel >= sfinfo.channels) {
+            fprintf(stderr, "Invalid reference channel %d for a file with %d channels\n", referenceChannel,
+                    sfinfo.channels);
+            free(interfererFreqs);
+            cleanup(NULL, NULL, inputChunk, outputChunk, frameChunk, infile, NULL);
+            return 1;
+        }
+        frameChunk = (float *)malloc(nSamples * (sfinfo.channels + 1) * sizeof(float));
+        if (!frameChunk) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            free(interfererFreqs);
+            cleanup(NULL, NULL, inputChunk, outputChunk, frameChunk, infile, NULL);
+            return -1;
+        }
+        // The output is the cleaned primary channel only
+        outinfo.channels = 1;
+    }
+    int primaryChannel = (referenceChannel == 0) ? 1 : 0;
+    float *referenceChunk = frameChunk ? frameChunk + nSamples * sfinfo.channels : NULL;
+
+    // Start with zero coefficients, the oscillator runs at the file sample rate.
+    // The block engine adapts once per chunk with FFTs, the buffer size is its block size.
+    int status = useBlock ? lmsBlockInit(&blockFilter, numLMSCoeffs, nSamples, mu, interfererFreqs[0], sfinfo.samplerate)
+                          : lmsInitMultiTone(&filter, numLMSCoeffs, mu, interfererFreqs, numTones, sfinfo.samplerate);
+    free(interfererFreqs);
+    if (status != 0) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        cleanup(&filter, &blockFilter, inputChunk, outputChunk, frameChunk, infile, NULL);
         return -1;
     }
+    // Normalized step, mu is then relative to the reference power (0 < mu < 2)
+    filter.normalized = normalized;
+    blockFilter.normalized = normalized;
+    float *adaptiveCoeffs = useBlock ? blockFilter.adaptiveCoeffs : filter.adaptiveCoeffs;
+
+    // Warm start from the state of an earlier run. A snapshot of another configuration is
+    // an error rather than a cold start, the periodic saves would overwrite it.
+    if (snapshotFile) {
+        status = lmsLoadSnapshot(&filter, snapshotFile);
+        if (status < 0) {
+            cleanup(&filter, &blockFilter, inputChunk, outputChunk, frameChunk, infile, NULL);
+            return -1;
+        }
+        printf(status == 0 ? "Loaded snapshot %s\n" : "No snapshot %s yet, starting from zero coefficients\n",
+               snapshotFile);
+    }
 
     // Open output WAV file
-    outfile = sf_open(outputFile, SFM_WRITE, &sfinfo);
+    outfile = sf_open(outputFile, SFM_WRITE, &outinfo);
     if (!outfile) {
         fprintf(stderr, "Could not open output file: %s\n", outputFile);
-        cleanup(adaptiveCoeffs, inputChunk, outputChunk, infile, outfile);
+        cleanup(&filter, &blockFilter, inputChunk, outputChunk, frameChunk, infile, outfile);
         return -1;
     }
 
     // Process audio file in chunks
-    while ((num_read = sf_read_float(infile, inputChunk, nSamples)) > 0) {
-        processLMS(inputChunk, outputChunk, adaptiveCoeffs, num_read, numLMSCoeffs, mu, interfererFreq, sfinfo.samplerate);
+    int chunkIndex = 0;
+    long totalOutput = 0;
+    long totalCoeffs = 0;
+    // Without a reference channel every sample is one of the primary signal.
+    // With one, num_read counts frames and both channels stream through the same loop.
+    while ((num_read = referenceChunk ? sf_readf_float(infile, frameChunk, nSamples)
+                                      : sf_read_float(infile, inputChunk, nSamples)) > 0) {
+        if (referenceChunk) {
+            for (int n = 0; n < num_read; n++) {
+                inputChunk[n] = frameChunk[n * sfinfo.channels + primaryChannel];
+                referenceChunk[n] = frameChunk[n * sfinfo.channels + referenceChannel];
+            }
+        }
+        if (useBlock) {
+            lmsBlockProcess(&blockFilter, referenceChunk, inputChunk, outputChunk, num_read);
+        } else if (referenceChunk) {
+            processLMSReference(&filter, referenceChunk, inputChunk, outputChunk, num_read);
+        } else {
+            processLMS(&filter, inputChunk, outputChunk, num_read);
+        }
         sf_write_float(outfile, outputChunk, num_read);
+        if (countDenormals) {
+            int output = countSubnormals(outputChunk, num_read);
+            int coeffs = countSubnormals(adaptiveCoeffs, numTones * numLMSCoeffs);
+            if (output > 0 || coeffs > 0) {
+                printf("chunk %d: %d subnormal outputs, %d subnormal coefficients\n", chunkIndex, output, coeffs);
+            }
+            totalOutput += output;
+            totalCoeffs += coeffs;
+        }
+        chunkIndex++;
+
+        // Save the adaptation regularly, a crash then only loses the last chunks
+        if (snapshotFile && chunkIndex % snapshotInterval == 0) {
+            lmsSaveSnapshot(&filter, snapshotFile);
+        }
+    }
+    if (snapshotFile && chunkIndex % snapshotInterval != 0) {
+        lmsSaveSnapshot(&filter, snapshotFile);
+    }
+    if (countDenormals) {
+        printf("%d chunks: %ld subnormal outputs, %ld subnormal coefficients\n", chunkIndex, totalOutput, totalCoeffs);
     }
 
     // Free resources
-    cleanup(adaptiveCoeffs, inputChunk, outputChunk, infile, outfile);
+    cleanup(&filter, &blockFilter, inputChunk, outputChunk, frameChunk, infile, outfile);
     return 0;
 }
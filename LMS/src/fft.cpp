@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <math.h>
+#include "../include/fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int fftNextPow2(int n) {
+    int size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// Twiddle and bit reversal tables
+int fftInit(FFTPlan *plan, int size) {
+    plan->size = size;
+    plan->twiddles = NULL;
+    plan->bitReverse = NULL;
+    if (size < 4 || (size & (size - 1)) != 0) {
+        return -1;
+    }
+
+    int half = size / 2;
+    plan->twiddles = (Complex*)malloc(half * sizeof(Complex));
+    plan->bitReverse = (int*)malloc(half * sizeof(int));
+    if (!plan->twiddles || !plan->bitReverse) {
+        fftFree(plan);
+        return -1;
+    }
+
+    for (int k = 0; k < half; k++) {
+        double phase = -2.0 * M_PI * k / size;
+        plan->twiddles[k].real = (float)cos(phase);
+        plan->twiddles[k].imag = (float)sin(phase);
+    }
+
+    int bits = 0;
+    while ((1 << bits) < half) {
+        bits++;
+    }
+    for (int i = 0; i < half; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        plan->bitReverse[i] = reversed;
+    }
+    return 0;
+}
+
+void fftFree(FFTPlan *plan) {
+    free(plan->twiddles);
+    free(plan->bitReverse);
+    plan->twiddles = NULL;
+    plan->bitReverse = NULL;
+}
+
+// Iterative radix-2 decimation in time. The size/2 point transform uses every
+// second twiddle of the size point table.
+void fftComplex(const FFTPlan *plan, Complex *data, bool inverse) {
+    int n = plan->size / 2;
+
+    for (int i = 0; i < n; i++) {
+        int j = plan->bitReverse[i];
+        if (j > i) {
+            Complex tmp = data[i];
+            data[i] = data[j];
+            data[j] = tmp;
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        int halfLen = len / 2;
+        int stride = plan->size / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < halfLen; k++) {
+                Complex w = plan->twiddles[k * stride];
+                if (inverse) {
+                    w.imag = -w.imag;
+                }
+                Complex *a = &data[start + k];
+                Complex *b = &data[start + k + halfLen];
+                float tr = b->real * w.real - b->imag * w.imag;
+                float ti = b->real * w.imag + b->imag * w.real;
+                b->real = a->real - tr;
+                b->imag = a->imag - ti;
+                a->real += tr;
+                a->imag += ti;
+            }
+        }
+    }
+}
+
+// Pack even/odd samples into one complex sequence, transform, then split
+void fftRealForward(const FFTPlan *plan, const float *input, Complex *spectrum) {
+    int half = plan->size / 2;
+
+    for (int i = 0; i < half; i++) {
+        spectrum[i].real = input[2 * i];
+        spectrum[i].imag = input[2 * i + 1];
+    }
+    fftComplex(plan, spectrum, false);
+
+    // Bins 0 and size/2 are purely real
+    float z0r = spectrum[0].real;
+    float z0i = spectrum[0].imag;
+    spectrum[0].real = z0r + z0i;
+    spectrum[0].imag = 0.0f;
+    spectrum[half].real = z0r - z0i;
+    spectrum[half].imag = 0.0f;
+
+    // Bins k and half-k are computed together so the split can run in place
+    for (int k = 1; k <= half / 2; k++) {
+        int m = half - k;
+        Complex zk = spectrum[k];
+        Complex zm = spectrum[m];
+
+        // Even part E = (Z[k] + conj(Z[m]))/2, odd part O = (Z[k] - conj(Z[m]))/(2j)
+        float ekr = 0.5f * (zk.real + zm.real);
+        float eki = 0.5f * (zk.imag - zm.imag);
+        float okr = 0.5f * (zk.imag + zm.imag);
+        float oki = -0.5f * (zk.real - zm.real);
+        Complex wk = plan->twiddles[k];
+        spectrum[k].real = ekr + wk.real * okr - wk.imag * oki;
+        spectrum[k].imag = eki + wk.real * oki + wk.imag * okr;
+
+        if (m != k) {
+            // E[m] = conj(E[k]), O[m] = conj(O[k])
+            Complex wm = plan->twiddles[m];
+            spectrum[m].real = ekr + wm.real * okr + wm.imag * oki;
+            spectrum[m].imag = -eki - wm.real * oki + wm.imag * okr;
+        }
+    }
+}
+
+// Undo the split step, inverse transform and unpack even/odd samples
+void fftRealInverse(const FFTPlan *plan, Complex *spectrum, float *output) {
+    int half = plan->size / 2;
+
+    float x0 = spectrum[0].real;
+    float xh = spectrum[half].real;
+    spectrum[0].real = 0.5f * (x0 + xh);
+    spectrum[0].imag = 0.5f * (x0 - xh);
+
+    for (int k = 1; k <= half / 2; k++) {
+        int m = half - k;
+        Complex xk = spectrum[k];
+        Complex xm = spectrum[m];
+
+        // E[k] = (X[k] + conj(X[m]))/2, O[k] = (X[k] - conj(X[m])) * conj(W[k])/2
+        float ekr = 0.5f * (xk.real + xm.real);
+        float eki = 0.5f * (xk.imag - xm.imag);
+        float dr = 0.5f * (xk.real - xm.real);
+        float di = 0.5f * (xk.imag + xm.imag);
+        Complex wk = plan->twiddles[k];
+        float okr = dr * wk.real + di * wk.imag;
+        float oki = di * wk.real - dr * wk.imag;
+
+        // Z[k] = E[k] + j*O[k]
+        spectrum[k].real = ekr - oki;
+        spectrum[k].imag = eki + okr;
+
+        if (m != k) {
+            // E[m] = conj(E[k]), O[m] = -conj(X[k] - conj(X[m])) * conj(W[m])/2
+            Complex wm = plan->twiddles[m];
+            float omr = -dr * wm.real + di * wm.imag;
+            float omi = di * wm.real + dr * wm.imag;
+            spectrum[m].real = ekr - omi;
+            spectrum[m].imag = -eki + omr;
+        }
+    }
+
+    fftComplex(plan, spectrum, true);
+
+    float scale = 1.0f / half;
+    for (int i = 0; i < half; i++) {
+        output[2 * i] = spectrum[i].real * scale;
+        output[2 * i + 1] = spectrum[i].imag * scale;
+    }
+}
@@ -1,18 +1,109 @@
+#include <stdlib.h>
 #include <math.h>
+#include "../include/lms.h"
 
-void processLMS(float *inputChunk, float *outputChunk, float *adaptiveCoeffs,
-                          int numSamples, int numLMSCoeffs, float mu, float interfererFreq,
-                          float sampleRate) {
-    static float currentPhase = 0.0;  // Current phase of the sinusoidal reference
-    float phaseIncrement = 2.0 * M_PI * interfererFreq / sampleRate;  // Phase increment per sample
+// Keeps the NLMS step finite while the reference is silent
+static const double NLMS_REGULARIZATION = 1e-6;
 
-    // Process each sample in the input chunk
+int lmsInit(LMSFilter *filter, int numLMSCoeffs, float mu, float interfererFreq, float sampleRate) {
+    return lmsInitMultiTone(filter, numLMSCoeffs, mu, &interfererFreq, 1, sampleRate);
+}
+
+// Allocate the filter and start every oscillator at phase zero
+int lmsInitMultiTone(LMSFilter *filter, int numLMSCoeffs, float mu, const float *interfererFreqs, int numTones,
+                     float sampleRate) {
+    int historyLength = numLMSCoeffs + 1;
+
+    filter->numLMSCoeffs = numLMSCoeffs;
+    filter->numTones = numTones;
+    filter->mu = mu;
+    filter->normalized = false;
+    filter->referenceIndex = 0;
+    filter->fused = lmsSelectKernel(numLMSCoeffs).fused;
+    filter->adaptiveCoeffs = (float*)calloc(numTones * numLMSCoeffs, sizeof(float));
+    filter->reference = (float*)calloc(numTones * 2 * historyLength, sizeof(float));
+    filter->oscillators = (LMSOscillator*)calloc(numTones, sizeof(LMSOscillator));
+    if (!filter->adaptiveCoeffs || !filter->reference || !filter->oscillators) {
+        return -1;
+    }
+
+    for (int t = 0; t < numTones; t++) {
+        double phaseIncrement = 2.0 * M_PI * interfererFreqs[t] / sampleRate;  // Phase increment per sample
+        LMSOscillator *oscillator = &filter->oscillators[t];
+        oscillator->cos = 1.0;
+        oscillator->sin = 0.0;
+        oscillator->rotCos = cos(phaseIncrement);
+        oscillator->rotSin = sin(phaseIncrement);
+
+        // Tap k of the first sample sees the reference k samples before phase zero.
+        // The first sample is written at historyLength - 1, older values follow it.
+        float *reference = filter->reference + t * 2 * historyLength;
+        for (int k = 1; k < historyLength; k++) {
+            float pastReference = (float)sin(-k * phaseIncrement);
+            reference[k - 1] = pastReference;
+            reference[k - 1 + historyLength] = pastReference;
+        }
+    }
+    return 0;
+}
+
+void lmsFree(LMSFilter *filter) {
+    free(filter->adaptiveCoeffs);
+    free(filter->reference);
+    free(filter->oscillators);
+    filter->adaptiveCoeffs = NULL;
+    filter->reference = NULL;
+    filter->oscillators = NULL;
+}
+
+// Shared by both entry points, referenceChunk replaces the oscillator of the first tone if given
+static void processBank(LMSFilter *filter, const float *referenceChunk, const float *inputChunk, float *outputChunk,
+                        int numSamples) {
+    int numLMSCoeffs = filter->numLMSCoeffs;
+    int numTones = filter->numTones;
+    int historyLength = numLMSCoeffs + 1;
+    int referenceIndex = filter->referenceIndex;
+    float mu = filter->mu;
+    LMSFusedKernel fused = filter->fused;
+    double energy = 0.0;
+
+    // The step of the previous sample is applied by the fused kernel of the next one,
+    // the first sample of the chunk has no pending update
+    float step = 0.0f;
     for (int n = 0; n < numSamples; n++) {
-        // Compute LMS filter output (estimate of the interference)
-        float filterOutput = 0.0;
-        for (int k = 0; k < numLMSCoeffs; k++) {
-            float pastReference = sinf(currentPhase - k * phaseIncrement);  // Reference for past samples
-            filterOutput += adaptiveCoeffs[k] * pastReference;
+        // Step back one position, the reference at the current phase is the first one of the window
+        referenceIndex = (referenceIndex == 0) ? historyLength - 1 : referenceIndex - 1;
+
+        // Sum of the estimates of all tones (interference)
+        float filterOutput = 0.0f;
+        for (int t = 0; t < numTones; t++) {
+            LMSOscillator *oscillator = &filter->oscillators[t];
+            float *reference = filter->reference + t * 2 * historyLength;
+            float value = (referenceChunk && t == 0) ? referenceChunk[n] : (float)oscillator->sin;
+            reference[referenceIndex] = value;
+            reference[referenceIndex + historyLength] = value;
+            const float *pastReference = reference + referenceIndex;
+
+            // Reference power over the windows, summed once per chunk and then updated
+            // with the values that enter and the ones that leave
+            if (filter->normalized) {
+                if (n == 0) {
+                    for (int k = 0; k < numLMSCoeffs; k++) {
+                        energy += (double)pastReference[k] * pastReference[k];
+                    }
+                } else {
+                    energy += (double)pastReference[0] * pastReference[0] -
+                              (double)pastReference[numLMSCoeffs] * pastReference[numLMSCoeffs];
+                }
+            }
+
+            // Update with the previous error, then the LMS filter output of this tone
+            filterOutput += fused(filter->adaptiveCoeffs + t * numLMSCoeffs, pastReference, step, numLMSCoeffs);
+
+            // Rotate the phasor to the phase of the next sample
+            double nextCos = oscillator->cos * oscillator->rotCos - oscillator->sin * oscillator->rotSin;
+            oscillator->sin = oscillator->sin * oscillator->rotCos + oscillator->cos * oscillator->rotSin;
+            oscillator->cos = nextCos;
         }
 
         // Compute error signal (desired signal minus estimated interference)
@@ -21,16 +112,36 @@ void processLMS(float *inputChunk, float *outputChunk, float *adaptiveCoeffs,
         // Save the error signal as the output
         outputChunk[n] = error;
 
-        // Update adaptive coefficients using the LMS rule
-        for (int k = 0; k < numLMSCoeffs; k++) {
-            float pastReference = sinf(currentPhase - k * phaseIncrement);  
-            adaptiveCoeffs[k] += 2 * mu * error * pastReference;
+        // Step size of the LMS rule for this error
+        if (filter->normalized) {
+            step = (float)(mu * error / (energy + NLMS_REGULARIZATION));
+        } else {
+            step = 2 * mu * error;
         }
+    }
 
-        // Update the phase for the next sample
-        currentPhase += phaseIncrement;
-        if (currentPhase > 2.0 * M_PI) {
-            currentPhase -= 2.0 * M_PI;  // Wrap phase to stay within [0, 2π]
+    for (int t = 0; t < numTones; t++) {
+        // Last update of the chunk, so the coefficients are current between calls
+        float *adaptiveCoeffs = filter->adaptiveCoeffs + t * numLMSCoeffs;
+        const float *pastReference = filter->reference + t * 2 * historyLength + referenceIndex;
+        for (int k = 0; k < numLMSCoeffs; k++) {
+            adaptiveCoeffs[k] += step * pastReference[k];
         }
+
+        // Rounding makes the phasor length drift slowly, pull it back to one once per chunk
+        LMSOscillator *oscillator = &filter->oscillators[t];
+        double norm = 1.0 / sqrt(oscillator->cos * oscillator->cos + oscillator->sin * oscillator->sin);
+        oscillator->cos *= norm;
+        oscillator->sin *= norm;
     }
+    filter->referenceIndex = referenceIndex;
+}
+
+void processLMS(LMSFilter *filter, const float *inputChunk, float *outputChunk, int numSamples) {
+    processBank(filter, NULL, inputChunk, outputChunk, numSamples);
+}
+
+void processLMSReference(LMSFilter *filter, const float *referenceChunk, const float *inputChunk, float *outputChunk,
+                         int numSamples) {
+    processBank(filter, referenceChunk, inputChunk, outputChunk, numSamples);
 }
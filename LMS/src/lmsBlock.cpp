@@ -0,0 +1,162 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/lmsBlock.h"
+
+// Smoothing of the per-bin reference power from block to block
+static const float POWER_SMOOTHING = 0.9f;
+
+int lmsBlockInit(LMSBlockFilter *filter, int numLMSCoeffs, int blockSize, float mu, float interfererFreq, float sampleRate) {
+    double phaseIncrement = 2.0 * M_PI * interfererFreq / sampleRate;  // Phase increment per sample
+
+    memset(filter, 0, sizeof(LMSBlockFilter));
+    filter->numLMSCoeffs = numLMSCoeffs;
+    filter->blockSize = blockSize;
+    filter->mu = mu;
+    filter->oscCos = 1.0;
+    filter->rotCos = cos(phaseIncrement);
+    filter->rotSin = sin(phaseIncrement);
+
+    // Every block output needs numLMSCoeffs-1 older reference samples in the same window
+    filter->fftSize = fftNextPow2(numLMSCoeffs + blockSize - 1);
+    if (filter->fftSize < 4) {
+        filter->fftSize = 4;
+    }
+    int fftSize = filter->fftSize;
+    int numBins = fftSize / 2 + 1;
+    if (fftInit(&filter->plan, fftSize) != 0) {
+        return -1;
+    }
+
+    filter->adaptiveCoeffs = (float*)calloc(numLMSCoeffs, sizeof(float));
+    filter->coeffSpectrum = (Complex*)calloc(numBins, sizeof(Complex));
+    filter->refSpectrum = (Complex*)calloc(numBins, sizeof(Complex));
+    filter->spectrum = (Complex*)calloc(numBins, sizeof(Complex));
+    filter->binPower = (float*)calloc(numBins, sizeof(float));
+    filter->reference = (float*)calloc(fftSize, sizeof(float));
+    filter->work = (float*)calloc(fftSize, sizeof(float));
+    if (!filter->adaptiveCoeffs || !filter->coeffSpectrum || !filter->refSpectrum || !filter->spectrum ||
+        !filter->binPower || !filter->reference || !filter->work) {
+        return -1;
+    }
+
+    // The window before the first block holds the reference before phase zero
+    for (int k = 1; k <= fftSize; k++) {
+        filter->reference[fftSize - k] = (float)sin(-k * phaseIncrement);
+    }
+    return 0;
+}
+
+void lmsBlockFree(LMSBlockFilter *filter) {
+    fftFree(&filter->plan);
+    free(filter->adaptiveCoeffs);
+    free(filter->coeffSpectrum);
+    free(filter->refSpectrum);
+    free(filter->spectrum);
+    free(filter->binPower);
+    free(filter->reference);
+    free(filter->work);
+    filter->adaptiveCoeffs = NULL;
+    filter->coeffSpectrum = NULL;
+    filter->refSpectrum = NULL;
+    filter->spectrum = NULL;
+    filter->binPower = NULL;
+    filter->reference = NULL;
+    filter->work = NULL;
+}
+
+// One block of n <= blockSize samples
+static void processBlock(LMSBlockFilter *filter, const float *referenceBlock, const float *inputBlock, float *outputBlock,
+                         int n) {
+    int fftSize = filter->fftSize;
+    int numBins = fftSize / 2 + 1;
+    int numLMSCoeffs = filter->numLMSCoeffs;
+    float *reference = filter->reference;
+    float *work = filter->work;
+    Complex *X = filter->refSpectrum;
+    Complex *S = filter->spectrum;
+    const Complex *W = filter->coeffSpectrum;
+
+    // Slide the reference window by n samples
+    memmove(reference, reference + n, (fftSize - n) * sizeof(float));
+    for (int i = 0; i < n; i++) {
+        if (referenceBlock) {
+            reference[fftSize - n + i] = referenceBlock[i];
+        } else {
+            reference[fftSize - n + i] = (float)filter->oscSin;
+            double nextCos = filter->oscCos * filter->rotCos - filter->oscSin * filter->rotSin;
+            filter->oscSin = filter->oscSin * filter->rotCos + filter->oscCos * filter->rotSin;
+            filter->oscCos = nextCos;
+        }
+    }
+
+    // Overlap-save filtering, the last n samples of the circular convolution are valid
+    fftRealForward(&filter->plan, reference, X);
+    for (int k = 0; k < numBins; k++) {
+        S[k].real = W[k].real * X[k].real - W[k].imag * X[k].imag;
+        S[k].imag = W[k].real * X[k].imag + W[k].imag * X[k].real;
+    }
+    fftRealInverse(&filter->plan, S, work);
+
+    // Error signal (desired signal minus estimated interference), zero padded in front
+    for (int i = 0; i < n; i++) {
+        outputBlock[i] = inputBlock[i] - work[fftSize - n + i];
+    }
+    memset(work, 0, (fftSize - n) * sizeof(float));
+    memcpy(work + fftSize - n, outputBlock, n * sizeof(float));
+    fftRealForward(&filter->plan, work, S);
+
+    // Cross-correlation of reference and error, optionally divided by the reference power per bin.
+    // The plain step uses the mean gradient of the block, so it is stable for the same mu as processLMS.
+    float scale = 2.0f * filter->mu / n;
+    if (filter->normalized) {
+        double meanPower = 0.0;
+        for (int k = 0; k < numBins; k++) {
+            float power = X[k].real * X[k].real + X[k].imag * X[k].imag;
+            filter->binPower[k] = filter->numBlocks == 0 ? power
+                                : POWER_SMOOTHING * filter->binPower[k] + (1.0f - POWER_SMOOTHING) * power;
+            meanPower += filter->binPower[k];
+        }
+        // Bins without reference power would get an unbounded step
+        float regularization = (float)(1e-3 * meanPower / numBins) + 1e-20f;
+        for (int k = 0; k < numBins; k++) {
+            float weight = 1.0f / (filter->binPower[k] + regularization);
+            float er = S[k].real * weight;
+            float ei = S[k].imag * weight;
+            S[k].real = X[k].real * er + X[k].imag * ei;
+            S[k].imag = X[k].real * ei - X[k].imag * er;
+        }
+        // |X|^2 is about fftSize times the reference variance, see docs/lms_block.md
+        scale = filter->mu * (float)fftSize / n;
+    } else {
+        for (int k = 0; k < numBins; k++) {
+            float er = S[k].real;
+            float ei = S[k].imag;
+            S[k].real = X[k].real * er + X[k].imag * ei;
+            S[k].imag = X[k].real * ei - X[k].imag * er;
+        }
+    }
+    fftRealInverse(&filter->plan, S, work);
+
+    // Gradient constraint: only the first numLMSCoeffs lags are coefficients
+    for (int k = 0; k < numLMSCoeffs; k++) {
+        filter->adaptiveCoeffs[k] += scale * work[k];
+    }
+    memcpy(work, filter->adaptiveCoeffs, numLMSCoeffs * sizeof(float));
+    memset(work + numLMSCoeffs, 0, (fftSize - numLMSCoeffs) * sizeof(float));
+    fftRealForward(&filter->plan, work, filter->coeffSpectrum);
+    filter->numBlocks++;
+}
+
+void lmsBlockProcess(LMSBlockFilter *filter, const float *referenceChunk, const float *inputChunk, float *outputChunk,
+                     int numSamples) {
+    for (int start = 0; start < numSamples; start += filter->blockSize) {
+        int n = numSamples - start < filter->blockSize ? numSamples - start : filter->blockSize;
+        processBlock(filter, referenceChunk ? referenceChunk + start : NULL, inputChunk + start, outputChunk + start, n);
+    }
+
+    // Rounding makes the phasor length drift slowly, pull it back to one once per chunk
+    double norm = 1.0 / sqrt(filter->oscCos * filter->oscCos + filter->oscSin * filter->oscSin);
+    filter->oscCos *= norm;
+    filter->oscSin *= norm;
+}
@@ -0,0 +1,120 @@
+#include "../include/lmsKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Same arithmetic as separate update and filter loops, tap by tap
+float lmsFusedScalar(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs) {
+    float filterOutput = 0.0f;
+    for (int k = 0; k < numLMSCoeffs; k++) {
+        adaptiveCoeffs[k] += step * window[k + 1];
+        filterOutput += adaptiveCoeffs[k] * window[k];
+    }
+    return filterOutput;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 2 x 8 lanes with fused multiply-add, the window is loaded twice with an offset of one
+__attribute__((target("avx2,fma")))
+float lmsFusedAVX2(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs) {
+    const __m256 steps = _mm256_set1_ps(step);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int k = 0;
+    for (; k + 16 <= numLMSCoeffs; k += 16) {
+        __m256 coeffs0 = _mm256_fmadd_ps(steps, _mm256_loadu_ps(window + k + 1), _mm256_loadu_ps(adaptiveCoeffs + k));
+        __m256 coeffs1 = _mm256_fmadd_ps(steps, _mm256_loadu_ps(window + k + 9), _mm256_loadu_ps(adaptiveCoeffs + k + 8));
+        _mm256_storeu_ps(adaptiveCoeffs + k, coeffs0);
+        _mm256_storeu_ps(adaptiveCoeffs + k + 8, coeffs1);
+        acc0 = _mm256_fmadd_ps(coeffs0, _mm256_loadu_ps(window + k), acc0);
+        acc1 = _mm256_fmadd_ps(coeffs1, _mm256_loadu_ps(window + k + 8), acc1);
+    }
+    for (; k + 8 <= numLMSCoeffs; k += 8) {
+        __m256 coeffs = _mm256_fmadd_ps(steps, _mm256_loadu_ps(window + k + 1), _mm256_loadu_ps(adaptiveCoeffs + k));
+        _mm256_storeu_ps(adaptiveCoeffs + k, coeffs);
+        acc0 = _mm256_fmadd_ps(coeffs, _mm256_loadu_ps(window + k), acc0);
+    }
+
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    float filterOutput = _mm_cvtss_f32(sum);
+    for (; k < numLMSCoeffs; k++) {
+        adaptiveCoeffs[k] += step * window[k + 1];
+        filterOutput += adaptiveCoeffs[k] * window[k];
+    }
+    return filterOutput;
+}
+
+// 16 lanes, masked tail
+__attribute__((target("avx512f")))
+float lmsFusedAVX512(float *adaptiveCoeffs, const float *window, float step, int numLMSCoeffs) {
+    const __m512 steps = _mm512_set1_ps(step);
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    int k = 0;
+    for (; k + 32 <= numLMSCoeffs; k += 32) {
+        __m512 coeffs0 = _mm512_fmadd_ps(steps, _mm512_loadu_ps(window + k + 1), _mm512_loadu_ps(adaptiveCoeffs + k));
+        __m512 coeffs1 = _mm512_fmadd_ps(steps, _mm512_loadu_ps(window + k + 17), _mm512_loadu_ps(adaptiveCoeffs + k + 16));
+        _mm512_storeu_ps(adaptiveCoeffs + k, coeffs0);
+        _mm512_storeu_ps(adaptiveCoeffs + k + 16, coeffs1);
+        acc0 = _mm512_fmadd_ps(coeffs0, _mm512_loadu_ps(window + k), acc0);
+        acc1 = _mm512_fmadd_ps(coeffs1, _mm512_loadu_ps(window + k + 16), acc1);
+    }
+    for (; k < numLMSCoeffs; k += 16) {
+        int remaining = numLMSCoeffs - k;
+        __mmask16 mask = remaining >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << remaining) - 1);
+        __m512 coeffs = _mm512_fmadd_ps(steps, _mm512_maskz_loadu_ps(mask, window + k + 1),
+                                        _mm512_maskz_loadu_ps(mask, adaptiveCoeffs + k));
+        _mm512_mask_storeu_ps(adaptiveCoeffs + k, mask, coeffs);
+        acc0 = _mm512_fmadd_ps(coeffs, _mm512_maskz_loadu_ps(mask, window + k), acc0);
+    }
+
+    // Same lane-halving reduction in registers as the FIR kernel
+    __m512 sum16 = _mm512_add_ps(acc0, acc1);
+    sum16 = _mm512_add_ps(sum16, _mm512_mask_shuffle_f32x4(sum16, 0xFFFF, sum16, sum16, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum16 = _mm512_add_ps(sum16, _mm512_mask_shuffle_f32x4(sum16, 0xFFFF, sum16, sum16, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m128 sum4 = _mm512_mask_extractf32x4_ps(_mm_setzero_ps(), 0xF, sum16, 0);
+    __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    return _mm_cvtss_f32(_mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1)));
+}
+
+#endif
+
+// Kernels supported by the host CPU
+int lmsAvailableKernels(LMSKernelInfo *kernels, int maxKernels) {
+    int count = 0;
+    if (count < maxKernels) {
+        kernels[count++] = {"scalar", lmsFusedScalar};
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (count < maxKernels && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels[count++] = {"avx2", lmsFusedAVX2};
+    }
+    if (count < maxKernels && __builtin_cpu_supports("avx512f")) {
+        kernels[count++] = {"avx512", lmsFusedAVX512};
+    }
+#endif
+    return count;
+}
+
+// Last entry is the widest supported instruction set. The AVX-512 kernel only pays off
+// from 256 taps (masked tail, reduction) and below 16 taps the scalar loop is as fast
+// as any vector kernel.
+LMSKernelInfo lmsSelectKernel(int numLMSCoeffs) {
+    LMSKernelInfo kernels[3];
+    int count = lmsAvailableKernels(kernels, 3);
+#if defined(__x86_64__) || defined(__i386__)
+    if (count > 1 && numLMSCoeffs < 256 && kernels[count - 1].fused == lmsFusedAVX512) {
+        count--;
+    }
+#endif
+    if (numLMSCoeffs < 16) {
+        count = 1;
+    }
+    return kernels[count - 1];
+}
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "../include/lmsSnapshot.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[4] = {'L', 'M', 'S', 'S'};
+static const int32_t SNAPSHOT_VERSION = 1;
+
+// Oscillator rotations computed from the same frequency and sample rate agree to rounding
+static const double ROTATION_TOLERANCE = 1e-12;
+
+typedef struct {
+    char magic[4];
+    int32_t version;
+    int32_t numLMSCoeffs;
+    int32_t numTones;
+    int32_t referenceIndex;
+} LMSSnapshotHeader;
+
+// Push the file contents to the disk before the rename makes them visible
+static int syncFile(FILE *file) {
+    if (fflush(file) != 0) {
+        return -1;
+    }
+#if defined(_WIN32)
+    return _commit(_fileno(file));
+#else
+    return fsync(fileno(file));
+#endif
+}
+
+// rename() fails on Windows if the target exists
+static int replaceFile(const char *from, const char *to) {
+#if defined(_WIN32)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ? 0 : -1;
+#else
+    return rename(from, to);
+#endif
+}
+
+int lmsSaveSnapshot(const LMSFilter *filter, const char *path) {
+    int numLMSCoeffs = filter->numLMSCoeffs;
+    int numTones = filter->numTones;
+    size_t numCoeffs = (size_t)numTones * numLMSCoeffs;
+    size_t numReference = (size_t)numTones * 2 * (numLMSCoeffs + 1);
+
+    size_t pathLength = strlen(path);
+    char *tempPath = (char*)malloc(pathLength + 5);
+    if (!tempPath) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return -1;
+    }
+    memcpy(tempPath, path, pathLength);
+    memcpy(tempPath + pathLength, ".tmp", 5);
+
+    FILE *file = fopen(tempPath, "wb");
+    if (!file) {
+        fprintf(stderr, "Could not open snapshot file: %s\n", tempPath);
+        free(tempPath);
+        return -1;
+    }
+
+    LMSSnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.numLMSCoeffs = numLMSCoeffs;
+    header.numTones = numTones;
+    header.referenceIndex = filter->referenceIndex;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(filter->oscillators, sizeof(LMSOscillator), numTones, file) == (size_t)numTones &&
+              fwrite(filter->adaptiveCoeffs, sizeof(float), numCoeffs, file) == numCoeffs &&
+              fwrite(filter->reference, sizeof(float), numReference, file) == numReference &&
+              syncFile(file) == 0;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || replaceFile(tempPath, path) != 0) {
+        fprintf(stderr, "Could not write snapshot file: %s\n", path);
+        remove(tempPath);
+        free(tempPath);
+        return -1;
+    }
+    free(tempPath);
+    return 0;
+}
+
+int lmsLoadSnapshot(LMSFilter *filter, const char *path) {
+    int numLMSCoeffs = filter->numLMSCoeffs;
+    int numTones = filter->numTones;
+    size_t numCoeffs = (size_t)numTones * numLMSCoeffs;
+    size_t numReference = (size_t)numTones * 2 * (numLMSCoeffs + 1);
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        if (errno == ENOENT) {
+            return 1;
+        }
+        fprintf(stderr, "Could not open snapshot file: %s\n", path);
+        return -1;
+    }
+
+    LMSSnapshotHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 ||
+        header.version != SNAPSHOT_VERSION) {
+        fprintf(stderr, "Not an LMS snapshot: %s\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.numLMSCoeffs != numLMSCoeffs || header.numTones != numTones || header.referenceIndex < 0 ||
+        header.referenceIndex > numLMSCoeffs) {
+        fprintf(stderr, "Snapshot %s has %d taps and %d tones, the filter %d taps and %d tones\n", path,
+                header.numLMSCoeffs, header.numTones, numLMSCoeffs, numTones);
+        fclose(file);
+        return -1;
+    }
+
+    // Read into temporary buffers, the filter keeps its state if anything is wrong
+    LMSOscillator *oscillators = (LMSOscillator*)malloc(numTones * sizeof(LMSOscillator));
+    float *adaptiveCoeffs = (float*)malloc(numCoeffs * sizeof(float));
+    float *reference = (float*)malloc(numReference * sizeof(float));
+    if (!oscillators || !adaptiveCoeffs || !reference) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(oscillators);
+        free(adaptiveCoeffs);
+        free(reference);
+        fclose(file);
+        return -1;
+    }
+    bool ok = fread(oscillators, sizeof(LMSOscillator), numTones, file) == (size_t)numTones &&
+              fread(adaptiveCoeffs, sizeof(float), numCoeffs, file) == numCoeffs &&
+              fread(reference, sizeof(float), numReference, file) == numReference &&
+              fgetc(file) == EOF;
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Snapshot file %s is truncated or too long\n", path);
+    }
+
+    // Coefficients adapted to other interferer frequencies are of no use
+    for (int t = 0; ok && t < numTones; t++) {
+        if (fabs(oscillators[t].rotCos - filter->oscillators[t].rotCos) > ROTATION_TOLERANCE ||
+            fabs(oscillators[t].rotSin - filter->oscillators[t].rotSin) > ROTATION_TOLERANCE) {
+            fprintf(stderr, "Snapshot %s was adapted to other interferer frequencies\n", path);
+            ok = false;
+        }
+    }
+    if (ok) {
+        for (int t = 0; t < numTones; t++) {
+            filter->oscillators[t].cos = oscillators[t].cos;
+            filter->oscillators[t].sin = oscillators[t].sin;
+        }
+        memcpy(filter->adaptiveCoeffs, adaptiveCoeffs, numCoeffs * sizeof(float));
+        memcpy(filter->reference, reference, numReference * sizeof(float));
+        filter->referenceIndex = header.referenceIndex;
+    }
+    free(oscillators);
+    free(adaptiveCoeffs);
+    free(reference);
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,50 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// One measured case. params holds the sweep values as JSON members, e.g. "\"taps\": 64, \"chunk\": 256"
+typedef struct {
+    const char *module;
+    const char *kernel;
+    char params[128];
+    double nsPerSample;
+    double samplesPerSecond;
+    double cyclesPerSample;  // TSC cycles, negative if the host has no cycle counter
+} BenchResult;
+
+typedef struct {
+    BenchResult *results;
+    int numResults;
+    int capacity;
+    double minSeconds;  // minimum run time per case
+} BenchSuite;
+
+// Processes one call worth of samples, context is owned by the caller
+typedef void (*BenchBody)(void *context);
+
+int benchInit(BenchSuite *suite, double minSeconds);
+void benchFree(BenchSuite *suite);
+
+// Time body until minSeconds have passed (at least 3 calls, after one warm-up call),
+// print the case and add it to the suite. samplesPerCall is the number of input
+// samples one call consumes.
+void benchRun(BenchSuite *suite, const char *module, const char *kernel, const char *params,
+              long samplesPerCall, BenchBody body, void *context);
+
+// Save all results as JSON. Returns 0 on success, -1 on failure.
+int benchWriteJSON(const BenchSuite *suite, const char *filename);
+
+// Fill a buffer with uniform noise in [-0.5, 0.5)
+void benchNoise(float *data, int n);
+
+// One entry point per module, each lives in its own translation unit because the
+// module headers share include guards and type names
+void benchFIR(BenchSuite *suite);
+void benchIIR(BenchSuite *suite);
+void benchLMS(BenchSuite *suite);
+void benchDownsampling(BenchSuite *suite);
+void benchInstFreq(BenchSuite *suite);
+void benchDFT(BenchSuite *suite);
+
+#endif
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <chrono>
+#include "../include/bench.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Time stamp counter, 0 where there is none
+static uint64_t readCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+int benchInit(BenchSuite *suite, double minSeconds) {
+    suite->numResults = 0;
+    suite->capacity = 64;
+    suite->minSeconds = minSeconds;
+    suite->results = (BenchResult*)malloc(suite->capacity * sizeof(BenchResult));
+    return suite->results ? 0 : -1;
+}
+
+void benchFree(BenchSuite *suite) {
+    free(suite->results);
+    suite->results = NULL;
+    suite->numResults = 0;
+    suite->capacity = 0;
+}
+
+void benchRun(BenchSuite *suite, const char *module, const char *kernel, const char *params,
+              long samplesPerCall, BenchBody body, void *context) {
+    body(context);
+
+    long numCalls = 0;
+    double seconds = 0.0;
+    uint64_t startCycles = readCycles();
+    auto start = std::chrono::steady_clock::now();
+    while (numCalls < 3 || seconds < suite->minSeconds) {
+        body(context);
+        numCalls++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    uint64_t cycles = readCycles() - startCycles;
+
+    double numSamples = (double)samplesPerCall * numCalls;
+    BenchResult result;
+    result.module = module;
+    result.kernel = kernel;
+    snprintf(result.params, sizeof(result.params), "%s", params);
+    result.nsPerSample = seconds * 1e9 / numSamples;
+    result.samplesPerSecond = numSamples / seconds;
+    result.cyclesPerSample = (startCycles != 0) ? cycles / numSamples : -1.0;
+
+    printf("%-13s %-22s %-36s %10.2f ns/sample %10.2f Msamples/s %10.2f cycles/sample\n", module, kernel, params,
+           result.nsPerSample, result.samplesPerSecond * 1e-6, result.cyclesPerSample);
+    fflush(stdout);
+
+    if (suite->numResults == suite->capacity) {
+        BenchResult *grown = (BenchResult*)realloc(suite->results, 2 * suite->capacity * sizeof(BenchResult));
+        if (!grown) {
+            fprintf(stderr, "Failed to allocate memory, result not stored\n");
+            return;
+        }
+        suite->results = grown;
+        suite->capacity *= 2;
+    }
+    suite->results[suite->numResults++] = result;
+}
+
+int benchWriteJSON(const BenchSuite *suite, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Can't open output file: %s\n", filename);
+        return -1;
+    }
+
+    char timestamp[32];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"timestamp\": \"%s\",\n", timestamp);
+#ifdef __VERSION__
+    fprintf(file, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    fprintf(file, "  \"min_seconds\": %g,\n", suite->minSeconds);
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < suite->numResults; i++) {
+        const BenchResult *result = &suite->results[i];
+        fprintf(file, "    {\"module\": \"%s\", \"kernel\": \"%s\", \"params\": {%s}, ", result->module,
+                result->kernel, result->params);
+        fprintf(file, "\"ns_per_sample\": %.4f, \"samples_per_s\": %.1f, ", result->nsPerSample,
+                result->samplesPerSecond);
+        if (result->cyclesPerSample >= 0.0) {
+            fprintf(file, "\"cycles_per_sample\": %.4f}", result->cyclesPerSample);
+        } else {
+            fprintf(file, "\"cycles_per_sample\": null}");
+        }
+        fprintf(file, "%s\n", (i + 1 < suite->numResults) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    fclose(file);
+    return 0;
+}
+
+void benchNoise(float *data, int n) {
+    for (int i = 0; i < n; i++) {
+        data[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/bench.h"
+#include "../../DFT/include/dft.h"
+
+typedef struct {
+    Complex *input;
+    Complex *output;
+    int NDFT;
+    bool inverse;
+} DFTCase;
+
+static void runDFT(void *context) {
+    DFTCase *c = (DFTCase*)context;
+    if (c->inverse) {
+        compute_idft(c->input, c->output, c->NDFT);
+    } else {
+        compute_dft(c->input, c->output, c->NDFT);
+    }
+}
+
+// compute_dft and compute_idft over transform size, one call transforms NDFT samples
+void benchDFT(BenchSuite *suite) {
+    const int sizes[] = {64, 128, 256, 512, 1024};
+    const int maxSize = 1024;
+
+    Complex *input = (Complex*)malloc(maxSize * sizeof(Complex));
+    Complex *output = (Complex*)malloc(maxSize * sizeof(Complex));
+    if (!input || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(input);
+        free(output);
+        return;
+    }
+    for (int n = 0; n < maxSize; n++) {
+        input[n].real = (float)rand() / RAND_MAX - 0.5f;
+        input[n].imag = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        for (int s = 0; s < 5; s++) {
+            DFTCase dft = {input, output, sizes[s], inverse != 0};
+
+            char params[128];
+            snprintf(params, sizeof(params), "\"size\": %d", sizes[s]);
+            benchRun(suite, "DFT", inverse ? "compute_idft" : "compute_dft", params, sizes[s], runDFT, &dft);
+        }
+    }
+
+    free(input);
+    free(output);
+}
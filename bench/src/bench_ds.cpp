@@ -0,0 +1,491 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/bench.h"
+#include "../../Downsampling/include/ds.h"
+#include "../../Downsampling/include/decimator.h"
+#include "../../Downsampling/include/resampler.h"
+#include "../../Downsampling/include/multistage.h"
+#include "../../Downsampling/include/firDesign.h"
+#include "../../Downsampling/include/nco.h"
+#include "../../Downsampling/include/channelizer.h"
+#include "../../Downsampling/include/interpolator.h"
+
+typedef struct {
+    double *input;
+    double *output;
+    double *firCoeffs;
+    double *buffer;
+    int nSamples;
+    int numFIRCoeffs;
+    int bufferSize;
+    FIRSymmetry symmetry;
+} DSCase;
+
+typedef struct {
+    Decimator decimator;
+    double *input;
+    double *output;
+    int nSamples;
+} DecimatorCase;
+
+typedef struct {
+    MultistageDecimator decimator;
+    double *input;
+    double *output;
+    int nSamples;
+} MultistageCase;
+
+typedef struct {
+    Resampler resampler;
+    double *input;
+    double *output;
+    int nSamples;
+} ResamplerCase;
+
+// processSignal on the zero-stuffed input with the full prototype filter, the only way
+// to resample by L/M with it
+typedef struct {
+    double *input;
+    double *upsampled;
+    double *output;
+    double *firCoeffs;
+    double *buffer;
+    int nSamples;
+    int interpolation;
+    int decimation;
+    int numFIRCoeffs;
+    int bufferSize;
+    FIRSymmetry symmetry;
+} ZeroStuffedCase;
+
+typedef struct {
+    NCO nco;
+    double phase;            // libm reference only
+    double *input;
+    double *inPhase;
+    double *quadrature;
+    int nSamples;
+} MixerCase;
+
+typedef struct {
+    Interpolator interpolator;
+    double *input;
+    double *output;
+    int nSamples;
+} InterpolatorCase;
+
+typedef struct {
+    Channelizer channelizer;
+    double *input;
+    ChannelSample *output;
+    int nSamples;
+} ChannelizerCase;
+
+// The same channels one at a time: NCO down-mix, then an I and a Q decimator each
+typedef struct {
+    NCO *ncos;
+    Decimator *decimators;   // 2 per channel, in-phase and quadrature
+    int numChannels;
+    double *input;
+    double *inPhase;
+    double *quadrature;
+    double *output;
+    int nSamples;
+} ChannelMixerCase;
+
+static const int downsamplingFactor = 4;
+
+static void runDownsampling(void *context) {
+    DSCase *c = (DSCase*)context;
+    processSignal(c->input, c->output, c->firCoeffs, c->buffer, c->nSamples, c->numFIRCoeffs, c->bufferSize,
+                  downsamplingFactor, 0.1, c->symmetry);
+}
+
+static void runDecimator(void *context) {
+    DecimatorCase *c = (DecimatorCase*)context;
+    decimatorProcess(&c->decimator, c->input, c->output, c->nSamples);
+}
+
+static void runMultistage(void *context) {
+    MultistageCase *c = (MultistageCase*)context;
+    multistageProcess(&c->decimator, c->input, c->output, c->nSamples);
+}
+
+static void runNCO(void *context) {
+    MixerCase *c = (MixerCase*)context;
+    ncoMixDown(&c->nco, c->input, c->inPhase, c->quadrature, c->nSamples);
+}
+
+// Complex mix with a phase accumulator and libm, as processSignal does for the real mix
+static void runLibmMixer(void *context) {
+    MixerCase *c = (MixerCase*)context;
+    double phaseIncrement = 2 * M_PI * 0.1;
+    for (int n = 0; n < c->nSamples; n++) {
+        c->inPhase[n] = c->input[n] * cos(c->phase);
+        c->quadrature[n] = -c->input[n] * sin(c->phase);
+        c->phase += phaseIncrement;
+        if (c->phase >= 2.0 * M_PI) {
+            c->phase -= 2.0 * M_PI;
+        }
+    }
+}
+
+// I/Q down-mixing, table NCO against cos and sin per sample
+static void benchMixers(BenchSuite *suite, double *input, int nSamples) {
+    MixerCase mix;
+    mix.phase = 0.0;
+    mix.input = input;
+    mix.nSamples = nSamples;
+    mix.inPhase = (double*)malloc(nSamples * sizeof(double));
+    mix.quadrature = (double*)malloc(nSamples * sizeof(double));
+    if (!mix.inPhase || !mix.quadrature) {
+        fprintf(stderr, "Failed to allocate memory\n");
+    } else {
+        ncoInit(&mix.nco, 0.1);
+        char params[128];
+        snprintf(params, sizeof(params), "\"chunk\": %d", nSamples);
+        benchRun(suite, "Downsampling", "ncoMixDown", params, nSamples, runNCO, &mix);
+        benchRun(suite, "Downsampling", "libm cos/sin mixer", params, nSamples, runLibmMixer, &mix);
+    }
+    free(mix.inPhase);
+    free(mix.quadrature);
+}
+
+static void runInterpolator(void *context) {
+    InterpolatorCase *c = (InterpolatorCase*)context;
+    interpolatorProcess(&c->interpolator, c->input, c->output, c->nSamples);
+}
+
+static void runChannelizer(void *context) {
+    ChannelizerCase *c = (ChannelizerCase*)context;
+    channelizerProcess(&c->channelizer, c->input, c->output, c->nSamples);
+}
+
+static void runChannelMixers(void *context) {
+    ChannelMixerCase *c = (ChannelMixerCase*)context;
+    for (int k = 0; k < c->numChannels; k++) {
+        ncoMixDown(&c->ncos[k], c->input, c->inPhase, c->quadrature, c->nSamples);
+        decimatorProcess(&c->decimators[2 * k], c->inPhase, c->output, c->nSamples);
+        decimatorProcess(&c->decimators[2 * k + 1], c->quadrature, c->output, c->nSamples);
+    }
+}
+
+// Critically sampled filter bank with 12 taps per channel, against a mixer and two
+// decimators with the same prototype for each of the numChannels / 2 + 1 channels
+static void benchChannelizer(BenchSuite *suite, double *input, int nSamples) {
+    const int channels[] = {16, 64};
+    const int tapsPerChannel = 12;
+
+    for (int c = 0; c < 2; c++) {
+        int numChannels = channels[c];
+        int numBins = numChannels / 2 + 1;
+        int numFIRCoeffs = numChannels * tapsPerChannel;
+        int numBlocks = (nSamples + numChannels - 1) / numChannels;
+        char params[128];
+        snprintf(params, sizeof(params), "\"channels\": %d, \"taps per channel\": %d, \"chunk\": %d", numChannels,
+                 tapsPerChannel, nSamples);
+
+        ChannelizerCase ch;
+        ch.input = input;
+        ch.nSamples = nSamples;
+        ch.output = (ChannelSample*)malloc(numBlocks * numBins * sizeof(ChannelSample));
+        if (channelizerInit(&ch.channelizer, numChannels, tapsPerChannel, numChannels) != 0 || !ch.output) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            channelizerFree(&ch.channelizer);
+            free(ch.output);
+            return;
+        }
+        benchRun(suite, "Downsampling", "channelizerProcess", params, nSamples, runChannelizer, &ch);
+
+        ChannelMixerCase mix;
+        mix.numChannels = numBins;
+        mix.input = input;
+        mix.nSamples = nSamples;
+        mix.ncos = (NCO*)malloc(numBins * sizeof(NCO));
+        mix.decimators = (Decimator*)calloc(2 * numBins, sizeof(Decimator));
+        mix.inPhase = (double*)malloc(nSamples * sizeof(double));
+        mix.quadrature = (double*)malloc(nSamples * sizeof(double));
+        mix.output = (double*)malloc(numBlocks * sizeof(double));
+        bool ready = mix.ncos && mix.decimators && mix.inPhase && mix.quadrature && mix.output;
+        for (int k = 0; ready && k < numBins; k++) {
+            ncoInit(&mix.ncos[k], (double)k / numChannels);
+            for (int p = 0; p < 2; p++) {
+                if (decimatorInit(&mix.decimators[2 * k + p], ch.channelizer.prototype, numFIRCoeffs, numChannels, 0.0) != 0) {
+                    ready = false;
+                }
+            }
+        }
+        if (!ready) {
+            fprintf(stderr, "Failed to allocate memory\n");
+        } else {
+            benchRun(suite, "Downsampling", "ncoMixDown + decimatorProcess per channel", params, nSamples,
+                     runChannelMixers, &mix);
+        }
+        for (int k = 0; mix.decimators && k < 2 * numBins; k++) {
+            decimatorFree(&mix.decimators[k]);
+        }
+        free(mix.ncos);
+        free(mix.decimators);
+        free(mix.inPhase);
+        free(mix.quadrature);
+        free(mix.output);
+        channelizerFree(&ch.channelizer);
+        free(ch.output);
+    }
+}
+
+static void runResampler(void *context) {
+    ResamplerCase *c = (ResamplerCase*)context;
+    resamplerProcess(&c->resampler, c->input, c->output, c->nSamples);
+}
+
+static void runZeroStuffed(void *context) {
+    ZeroStuffedCase *c = (ZeroStuffedCase*)context;
+    int numUpsampled = c->nSamples * c->interpolation;
+    memset(c->upsampled, 0, numUpsampled * sizeof(double));
+    for (int n = 0; n < c->nSamples; n++) {
+        c->upsampled[n * c->interpolation] = c->input[n];
+    }
+    processSignal(c->upsampled, c->output, c->firCoeffs, c->buffer, numUpsampled, c->numFIRCoeffs, c->bufferSize,
+                  c->decimation, 0.0, c->symmetry);
+}
+
+// Large factors: the planned CIC / half-band / FIR cascade against one Kaiser FIR for the
+// same spec. Edges are in units of the output rate, 80 dB. The last spec has its stopband
+// edge just below the output Nyquist frequency.
+static void benchMultistage(BenchSuite *suite, const double *input, int nSamples) {
+    const int factors[] = {64, 256, 1024, 64};
+    const double passbands[] = {0.4, 0.4, 0.4, 0.32};
+    const double stopbands[] = {0.5, 0.5, 0.5, 0.4992};
+    const double attenuationDb = 80.0;
+    double *output = (double*)malloc(nSamples * sizeof(double));
+    if (!output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return;
+    }
+
+    for (int f = 0; f < 4; f++) {
+        int factor = factors[f];
+        double passband = passbands[f] / factor;
+        double stopband = stopbands[f] / factor;
+        DecimationPlan plan;
+        if (planDecimation(&plan, factor, passband, stopband, attenuationDb) != 0) {
+            continue;
+        }
+
+        MultistageCase ms = {{}, (double*)input, output, nSamples};
+        if (multistageInit(&ms.decimator, &plan, 0.1, nSamples) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+        } else {
+            char params[128];
+            snprintf(params, sizeof(params), "\"factor\": %d, \"stopband\": %g, \"stages\": %d, \"chunk\": %d", factor,
+                     stopbands[f], plan.numStages, nSamples);
+            benchRun(suite, "Downsampling", "multistageProcess", params, nSamples, runMultistage, &ms);
+        }
+        multistageFree(&ms.decimator);
+
+        int numFIRCoeffs = kaiserLength(attenuationDb, stopband - passband) | 1;
+        double *firCoeffs = (double*)malloc(numFIRCoeffs * sizeof(double));
+        DecimatorCase dec = {{}, (double*)input, output, nSamples};
+        if (!firCoeffs) {
+            fprintf(stderr, "Failed to allocate memory\n");
+        } else {
+            designLowpass(firCoeffs, numFIRCoeffs, 0.5 * (passband + stopband), kaiserBeta(attenuationDb));
+            if (decimatorInit(&dec.decimator, firCoeffs, numFIRCoeffs, factor, 0.1) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+            } else {
+                char params[128];
+                snprintf(params, sizeof(params), "\"factor\": %d, \"stopband\": %g, \"taps\": %d, \"chunk\": %d", factor,
+                         stopbands[f], numFIRCoeffs, nSamples);
+                benchRun(suite, "Downsampling", "decimatorProcess single stage", params, nSamples, runDecimator, &dec);
+            }
+        }
+        decimatorFree(&dec.decimator);
+        free(firCoeffs);
+    }
+    free(output);
+}
+
+// Rational resampling 44.1k <-> 48k with 32 taps per phase, against processSignal on
+// the zero-stuffed signal. processSignal keeps its buffer position between calls, so
+// every case runs on the one buffer of bufferSize values.
+static void benchResampling(BenchSuite *suite, const double *input, double *buffer, int bufferSize) {
+    const int ratios[][2] = {{160, 147}, {147, 160}};
+    const int tapsPerPhase = 32;
+    const int nSamples = 256;
+
+    for (int r = 0; r < 2; r++) {
+        ResamplerCase rs;
+        rs.input = (double*)input;
+        rs.nSamples = nSamples;
+        if (resamplerInit(&rs.resampler, ratios[r][0], ratios[r][1], tapsPerPhase) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            resamplerFree(&rs.resampler);
+            return;
+        }
+        rs.output = (double*)malloc(resamplerMaxOutput(&rs.resampler, nSamples) * sizeof(double));
+
+        // processSignal writes one output per decimation-th upsampled sample
+        ZeroStuffedCase zs;
+        zs.input = (double*)input;
+        zs.nSamples = nSamples;
+        zs.interpolation = ratios[r][0];
+        zs.decimation = ratios[r][1];
+        zs.numFIRCoeffs = ratios[r][0] * tapsPerPhase;
+        zs.bufferSize = bufferSize;
+        zs.upsampled = (double*)malloc(nSamples * zs.interpolation * sizeof(double));
+        zs.output = (double*)malloc((nSamples * zs.interpolation / zs.decimation + 1) * sizeof(double));
+        zs.firCoeffs = (double*)malloc(zs.numFIRCoeffs * sizeof(double));
+        zs.buffer = buffer;
+        memset(buffer, 0, bufferSize * sizeof(double));
+        if (nSamples * zs.interpolation + zs.numFIRCoeffs - 1 > bufferSize) {
+            fprintf(stderr, "Zero-stuffed buffer too small for L = %d\n", zs.interpolation);
+        } else if (!rs.output || !zs.upsampled || !zs.output || !zs.firCoeffs) {
+            fprintf(stderr, "Failed to allocate memory\n");
+        } else {
+            // Same filter as the resampler, taken back out of its phases
+            for (int p = 0; p < zs.interpolation; p++) {
+                for (int j = 0; j < tapsPerPhase; j++) {
+                    zs.firCoeffs[p + j * zs.interpolation] = rs.resampler.polyphaseCoeffs[p * tapsPerPhase + j];
+                }
+            }
+            zs.symmetry = detectSymmetry(zs.firCoeffs, zs.numFIRCoeffs);
+
+            char params[128];
+            snprintf(params, sizeof(params), "\"L\": %d, \"M\": %d, \"taps per phase\": %d, \"chunk\": %d",
+                     ratios[r][0], ratios[r][1], tapsPerPhase, nSamples);
+            benchRun(suite, "Downsampling", "resamplerProcess", params, nSamples, runResampler, &rs);
+            benchRun(suite, "Downsampling", "processSignal zero-stuffed", params, nSamples, runZeroStuffed, &zs);
+        }
+        resamplerFree(&rs.resampler);
+        free(rs.output);
+        free(zs.upsampled);
+        free(zs.output);
+        free(zs.firCoeffs);
+    }
+}
+
+// Upsampling by 4 and 8 with a 127 tap low-pass, against processSignal on the
+// zero-stuffed signal with the same filter, on the buffer of the resampling cases
+static void benchInterpolation(BenchSuite *suite, const double *input, double *buffer, int bufferSize) {
+    const int factors[] = {4, 8};
+    const int numFIRCoeffs = 127;
+    const int nSamples = 256;
+
+    double *firCoeffs = (double*)malloc(numFIRCoeffs * sizeof(double));
+    if (!firCoeffs) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return;
+    }
+
+    for (int f = 0; f < 2; f++) {
+        int factor = factors[f];
+        designLowpass(firCoeffs, numFIRCoeffs, 0.5 / factor, kaiserBeta(80.0));
+
+        InterpolatorCase in;
+        in.input = (double*)input;
+        in.nSamples = nSamples;
+        in.output = (double*)malloc(nSamples * factor * sizeof(double));
+
+        ZeroStuffedCase zs;
+        zs.input = (double*)input;
+        zs.nSamples = nSamples;
+        zs.interpolation = factor;
+        zs.decimation = 1;
+        zs.numFIRCoeffs = numFIRCoeffs;
+        zs.bufferSize = bufferSize;
+        zs.upsampled = (double*)malloc(nSamples * factor * sizeof(double));
+        zs.output = (double*)malloc(nSamples * factor * sizeof(double));
+        zs.firCoeffs = firCoeffs;
+        zs.buffer = buffer;
+        zs.symmetry = detectSymmetry(firCoeffs, numFIRCoeffs);
+        memset(buffer, 0, bufferSize * sizeof(double));
+
+        if (interpolatorInit(&in.interpolator, firCoeffs, numFIRCoeffs, factor) != 0 || !in.output ||
+            !zs.upsampled || !zs.output) {
+            fprintf(stderr, "Failed to allocate memory\n");
+        } else if (nSamples * factor + numFIRCoeffs - 1 > bufferSize) {
+            fprintf(stderr, "Zero-stuffed buffer too small for factor %d\n", factor);
+        } else {
+            char params[128];
+            snprintf(params, sizeof(params), "\"factor\": %d, \"taps\": %d, \"chunk\": %d", factor, numFIRCoeffs,
+                     nSamples);
+            benchRun(suite, "Downsampling", "interpolatorProcess", params, nSamples, runInterpolator, &in);
+            benchRun(suite, "Downsampling", "processSignal zero-stuffed", params, nSamples, runZeroStuffed, &zs);
+        }
+        interpolatorFree(&in.interpolator);
+        free(in.output);
+        free(zs.upsampled);
+        free(zs.output);
+    }
+    free(firCoeffs);
+}
+
+// processSignal and the decimator (mix, filter, decimate by 4) over tap count and chunk
+// size, with a symmetric low-pass so the folded path is measured
+void benchDownsampling(BenchSuite *suite) {
+    const int taps[] = {31, 127, 511};
+    const int chunks[] = {256, 1024};
+    const int maxTaps = 511;
+    const int maxChunk = 1024;
+    // 256 samples zero-stuffed by L = 160 through 160 * 32 taps is the largest of the
+    // zero-stuffed cases
+    const int zeroStuffedSize = 256 * 160 + 160 * 32 - 1;
+
+    double *firCoeffs = (double*)malloc(maxTaps * sizeof(double));
+    double *input = (double*)malloc(maxChunk * sizeof(double));
+    double *output = (double*)malloc(maxChunk * sizeof(double));
+    double *buffer = (double*)malloc((maxChunk + maxTaps - 1) * sizeof(double));
+    double *zeroStuffedBuffer = (double*)malloc(zeroStuffedSize * sizeof(double));
+    if (!firCoeffs || !input || !output || !buffer || !zeroStuffedBuffer) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(firCoeffs);
+        free(input);
+        free(output);
+        free(buffer);
+        free(zeroStuffedBuffer);
+        return;
+    }
+    for (int n = 0; n < maxChunk; n++) {
+        input[n] = (double)rand() / RAND_MAX - 0.5;
+    }
+
+    for (int t = 0; t < 3; t++) {
+        for (int k = 0; k < taps[t]; k++) {
+            firCoeffs[k] = 1.0 / (1.0 + abs(k - taps[t] / 2));
+        }
+        for (int c = 0; c < 2; c++) {
+            int bufferSize = chunks[c] + taps[t] - 1;
+            memset(buffer, 0, bufferSize * sizeof(double));
+            DSCase ds = {input, output, firCoeffs, buffer, chunks[c], taps[t], bufferSize,
+                         detectSymmetry(firCoeffs, taps[t])};
+
+            char params[128];
+            snprintf(params, sizeof(params), "\"taps\": %d, \"chunk\": %d, \"factor\": %d", taps[t], chunks[c],
+                     downsamplingFactor);
+            benchRun(suite, "Downsampling", "processSignal", params, chunks[c], runDownsampling, &ds);
+
+            DecimatorCase dec = {{}, input, output, chunks[c]};
+            if (decimatorInit(&dec.decimator, firCoeffs, taps[t], downsamplingFactor, 0.1) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+            } else {
+                benchRun(suite, "Downsampling", "decimatorProcess", params, chunks[c], runDecimator, &dec);
+            }
+            decimatorFree(&dec.decimator);
+        }
+    }
+
+    benchMixers(suite, input, maxChunk);
+    benchResampling(suite, input, zeroStuffedBuffer, zeroStuffedSize);
+    benchMultistage(suite, input, maxChunk);
+    benchChannelizer(suite, input, maxChunk);
+    benchInterpolation(suite, input, zeroStuffedBuffer, zeroStuffedSize);
+
+    free(firCoeffs);
+    free(input);
+    free(output);
+    free(buffer);
+    free(zeroStuffedBuffer);
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/bench.h"
+#include "../../FIR/include/fir.h"
+
+typedef struct {
+    FIRFilter filter;
+    const float *input;
+    float *output;
+    int nSamples;
+} FIRCase;
+
+static void runFIR(void *context) {
+    FIRCase *c = (FIRCase*)context;
+    processSignal(&c->filter, c->input, c->output, c->nSamples);
+}
+
+// processSignal over tap count and chunk size
+void benchFIR(BenchSuite *suite) {
+    const int taps[] = {16, 64, 256, 1024};
+    const int chunks[] = {64, 256, 1024, 4096};
+    const int maxChunk = 4096;
+
+    float *firCoeffs = (float*)malloc(1024 * sizeof(float));
+    float *input = (float*)malloc(maxChunk * sizeof(float));
+    float *output = (float*)malloc(maxChunk * sizeof(float));
+    if (!firCoeffs || !input || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(firCoeffs);
+        free(input);
+        free(output);
+        return;
+    }
+    benchNoise(firCoeffs, 1024);
+    benchNoise(input, maxChunk);
+
+    for (int t = 0; t < 4; t++) {
+        for (int c = 0; c < 4; c++) {
+            FIRCase fir;
+            if (firInit(&fir.filter, firCoeffs, taps[t]) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+                continue;
+            }
+            fir.input = input;
+            fir.output = output;
+            fir.nSamples = chunks[c];
+
+            char params[128];
+            snprintf(params, sizeof(params), "\"taps\": %d, \"chunk\": %d", taps[t], chunks[c]);
+            benchRun(suite, "FIR", "processSignal", params, chunks[c], runFIR, &fir);
+            firFree(&fir.filter);
+        }
+    }
+
+    free(firCoeffs);
+    free(input);
+    free(output);
+}
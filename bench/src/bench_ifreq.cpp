@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/bench.h"
+#include "../../InstFreq/include/iFreq.h"
+
+typedef struct {
+    complex *input;
+    float *wrappedPhase;
+    float *unwrappedPhase;
+    float *instFreq;
+    size_t nSamples;
+    float lastWrappedPhase;
+    float lastPhaseCorrection;
+    float lastUnwrappedPhase;
+    int blockIdx;
+} IFCase;
+
+// One chunk the way IF_main runs it: atan2, unwrap, differentiate
+static void runInstFreq(void *context) {
+    IFCase *c = (IFCase*)context;
+    calculatePhases(c->input, c->wrappedPhase, c->nSamples);
+    unwrapPhase(c->wrappedPhase, c->unwrappedPhase, c->nSamples, &c->lastWrappedPhase, &c->lastPhaseCorrection);
+    calculateInstantaneousFrequency(c->unwrappedPhase, c->instFreq, c->blockIdx, &c->lastUnwrappedPhase,
+                                    c->nSamples, 48000.0f);
+    c->lastWrappedPhase = c->wrappedPhase[c->nSamples - 1];
+    c->lastUnwrappedPhase = c->unwrappedPhase[c->nSamples - 1];
+    c->blockIdx++;
+}
+
+// Phase, unwrap and frequency over chunk size
+void benchInstFreq(BenchSuite *suite) {
+    const int chunks[] = {64, 256, 1024, 4096};
+    const int maxChunk = 4096;
+
+    complex *input = (complex*)malloc(maxChunk * sizeof(complex));
+    float *wrappedPhase = (float*)malloc(maxChunk * sizeof(float));
+    float *unwrappedPhase = (float*)malloc(maxChunk * sizeof(float));
+    float *instFreq = (float*)malloc(maxChunk * sizeof(float));
+    if (!input || !wrappedPhase || !unwrappedPhase || !instFreq) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(input);
+        free(wrappedPhase);
+        free(unwrappedPhase);
+        free(instFreq);
+        return;
+    }
+
+    // Chirp-like I/Q test signal
+    for (int n = 0; n < maxChunk; n++) {
+        float phase = 2.0f * (float)M_PI * (0.01f * n + 1e-5f * n * n);
+        input[n].real = cosf(phase);
+        input[n].imag = sinf(phase);
+    }
+
+    for (int c = 0; c < 4; c++) {
+        IFCase ifreq = {input, wrappedPhase, unwrappedPhase, instFreq, (size_t)chunks[c], 0.0f, 0.0f, 0.0f, 0};
+
+        char params[128];
+        snprintf(params, sizeof(params), "\"chunk\": %d", chunks[c]);
+        benchRun(suite, "InstFreq", "phase+unwrap+freq", params, chunks[c], runInstFreq, &ifreq);
+    }
+
+    free(input);
+    free(wrappedPhase);
+    free(unwrappedPhase);
+    free(instFreq);
+}
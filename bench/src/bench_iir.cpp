@@ -0,0 +1,322 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../include/bench.h"
+#include "../../IIR/include/iir.h"
+#include "../../IIR/include/iir_cascade.h"
+#include "../../IIR/include/iir_multichannel.h"
+#include "../../IIR/include/iir_block.h"
+#include "../../IIR/include/denormal.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+typedef struct {
+    Biquad *filters;
+    size_t numFilters;
+    double *input;
+    double *output;
+    size_t nSamples;
+} IIRCase;
+
+typedef struct {
+    BiquadCascade cascade;
+    BiquadCascadeF cascadeF;
+    const double *input;
+    const float *inputF;
+    double *output;
+    float *outputF;
+    size_t nSamples;
+} CascadeCase;
+
+typedef struct {
+    BiquadBlock block;
+    const double *input;
+    double *output;
+    size_t nSamples;
+} BlockCase;
+
+typedef struct {
+    BiquadMulti multi;
+    const double *input;
+    double *output;
+    int numFrames;
+} MultiCase;
+
+static void runIIR(void *context) {
+    IIRCase *c = (IIRCase*)context;
+    process_chunk(c->input, c->output, c->nSamples, c->filters, c->numFilters);
+}
+
+static void runCascade(void *context) {
+    CascadeCase *c = (CascadeCase*)context;
+    cascade_process(&c->cascade, c->input, c->output, c->nSamples);
+}
+
+static void runCascadeF(void *context) {
+    CascadeCase *c = (CascadeCase*)context;
+    cascade_process_f(&c->cascadeF, c->inputF, c->outputF, c->nSamples);
+}
+
+// Butterworth low-pass section at fs/10, unity DC gain, so deep cascades stay bounded
+static void lowpassSection(Biquad *filter) {
+    double w0 = 2.0 * M_PI * 0.1;
+    double alpha = sin(w0) / (2.0 * M_SQRT1_2);
+    double a0 = 1.0 + alpha;
+    filter->b0 = (1.0 - cos(w0)) / 2.0 / a0;
+    filter->b1 = (1.0 - cos(w0)) / a0;
+    filter->b2 = filter->b0;
+    filter->a0 = 1.0;
+    filter->a1 = -2.0 * cos(w0) / a0;
+    filter->a2 = (1.0 - alpha) / a0;
+    filter->x1 = filter->x2 = 0.0;
+    filter->y1 = filter->y2 = 0.0;
+}
+
+static void runBlock(void *context) {
+    BlockCase *c = (BlockCase*)context;
+    block_process(&c->block, c->input, c->output, c->nSamples);
+}
+
+// Silent input into a cascade whose states start in the subnormal range, like the tail after a signal stops
+static void runSilentTail(void *context) {
+    IIRCase *c = (IIRCase*)context;
+    for (size_t j = 0; j < c->numFilters; j++) {
+        c->filters[j].x1 = c->filters[j].y1 = 1e-310;
+        c->filters[j].x2 = c->filters[j].y2 = -1e-310;
+    }
+    process_chunk(c->input, c->output, c->nSamples, c->filters, c->numFilters);
+}
+
+static void runMulti(void *context) {
+    MultiCase *c = (MultiCase*)context;
+    process_multichannel(&c->multi, c->input, c->output, c->numFrames);
+}
+
+// process_multichannel over channel count and lane width, 16 stages. ns/sample is per
+// channel sample, so a flat line over the channel count means extra channels are free.
+static void benchMultichannel(BenchSuite *suite, Biquad *filters) {
+    const int channels[] = {1, 4, 8, 16, 32};
+    const int widths[] = {4, 8, 16};
+    const int numStages = 16;
+    const int numFrames = 256;
+
+    double *input = (double*)malloc(numFrames * 32 * sizeof(double));
+    double *output = (double*)malloc(numFrames * 32 * sizeof(double));
+    if (!input || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(input);
+        free(output);
+        return;
+    }
+    for (int n = 0; n < numFrames * 32; n++) {
+        input[n] = (double)rand() / RAND_MAX - 0.5;
+    }
+    for (int j = 0; j < numStages; j++) {
+        lowpassSection(&filters[j]);
+    }
+
+    for (int w = 0; w < 3; w++) {
+        for (int c = 0; c < 5; c++) {
+            MultiCase multi;
+            if (multi_init(&multi.multi, filters, numStages, channels[c], widths[w], numFrames) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+                continue;
+            }
+            multi.input = input;
+            multi.output = output;
+            multi.numFrames = numFrames;
+
+            char params[128];
+            snprintf(params, sizeof(params), "\"stages\": %d, \"chunk\": %d, \"channels\": %d, \"lanes\": %d",
+                     numStages, numFrames, channels[c], widths[w]);
+            benchRun(suite, "IIR", "process_multichannel", params, (long)numFrames * channels[c], runMulti, &multi);
+            multi_free(&multi.multi);
+        }
+    }
+
+    free(input);
+    free(output);
+}
+
+// Largest deviation of the TDF-II engines from process_chunk, relative to the peak output
+static void reportCascadeAccuracy(Biquad *filters, int numFilters, const double *input, int nSamples) {
+    const int numChunks = 16;
+    BiquadCascade cascade;
+    BiquadCascadeF cascadeF;
+    BiquadBlock block4 = {}, block8 = {};
+    double *expected = (double*)malloc(nSamples * sizeof(double));
+    double *actual = (double*)malloc(nSamples * sizeof(double));
+    double *actual4 = (double*)malloc(nSamples * sizeof(double));
+    double *actual8 = (double*)malloc(nSamples * sizeof(double));
+    float *actualF = (float*)malloc(nSamples * sizeof(float));
+    bool ok = expected && actual && actual4 && actual8 && actualF;
+    if (ok) {
+        for (int j = 0; j < numFilters; j++) {
+            lowpassSection(&filters[j]);
+        }
+        ok = cascade_init(&cascade, filters, numFilters) == 0;
+        if (ok && cascade_init_f(&cascadeF, filters, numFilters) != 0) {
+            cascade_free(&cascade);
+            ok = false;
+        }
+        if (ok && (block_init(&block4, filters, numFilters, 4) != 0 || block_init(&block8, filters, numFilters, 8) != 0)) {
+            cascade_free(&cascade);
+            cascade_free_f(&cascadeF);
+            block_free(&block4);
+            block_free(&block8);
+            ok = false;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(expected);
+        free(actual);
+        free(actual4);
+        free(actual8);
+        free(actualF);
+        return;
+    }
+
+    double peak = 0.0, maxError = 0.0, maxErrorF = 0.0, maxError4 = 0.0, maxError8 = 0.0;
+    for (int c = 0; c < numChunks; c++) {
+        for (int n = 0; n < nSamples; n++) {
+            actualF[n] = (float)input[n];
+        }
+        process_chunk((double*)input, expected, nSamples, filters, numFilters);
+        cascade_process(&cascade, input, actual, nSamples);
+        cascade_process_f(&cascadeF, actualF, actualF, nSamples);
+        block_process(&block4, input, actual4, nSamples);
+        block_process(&block8, input, actual8, nSamples);
+        for (int n = 0; n < nSamples; n++) {
+            peak = fmax(peak, fabs(expected[n]));
+            maxError = fmax(maxError, fabs(actual[n] - expected[n]));
+            maxErrorF = fmax(maxErrorF, fabs(actualF[n] - expected[n]));
+            maxError4 = fmax(maxError4, fabs(actual4[n] - expected[n]));
+            maxError8 = fmax(maxError8, fabs(actual8[n] - expected[n]));
+        }
+    }
+    printf("IIR accuracy vs process_chunk, %d stages: tdf2 %.3g, tdf2f %.3g, block4 %.3g, block8 %.3g "
+           "(max error / peak output)\n", numFilters, maxError / peak, maxErrorF / peak, maxError4 / peak,
+           maxError8 / peak);
+
+    cascade_free(&cascade);
+    cascade_free_f(&cascadeF);
+    block_free(&block4);
+    block_free(&block8);
+    free(expected);
+    free(actual);
+    free(actual4);
+    free(actual8);
+    free(actualF);
+}
+
+// process_chunk on a decaying tail with the default MXCSR and with flush-to-zero
+static void benchSubnormals(BenchSuite *suite, Biquad *filters, double *output) {
+    const int numFilters = 16;
+    const int nSamples = 1024;
+    double *silence = (double*)calloc(nSamples, sizeof(double));
+    if (!silence) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return;
+    }
+    for (int j = 0; j < numFilters; j++) {
+        lowpassSection(&filters[j]);
+    }
+    IIRCase iir = {filters, (size_t)numFilters, silence, output, (size_t)nSamples};
+
+    benchRun(suite, "IIR", "process_chunk subnormal", "\"stages\": 16, \"chunk\": 1024, \"ftz\": false", nSamples,
+             runSilentTail, &iir);
+#if defined(__x86_64__) || defined(__i386__)
+    // The other benchmarks run with the default mode, so put it back afterwards
+    unsigned int csr = _mm_getcsr();
+    enable_flush_to_zero();
+    benchRun(suite, "IIR", "process_chunk subnormal", "\"stages\": 16, \"chunk\": 1024, \"ftz\": true", nSamples,
+             runSilentTail, &iir);
+    _mm_setcsr(csr);
+#endif
+    free(silence);
+}
+
+// process_chunk and the TDF-II engines over cascade depth and chunk size
+void benchIIR(BenchSuite *suite) {
+    const int depths[] = {1, 4, 16, 64};
+    const int chunks[] = {64, 1024};
+    const int maxChunk = 1024;
+
+    Biquad *filters = (Biquad*)malloc(64 * sizeof(Biquad));
+    double *input = (double*)malloc(maxChunk * sizeof(double));
+    double *output = (double*)malloc(maxChunk * sizeof(double));
+    float *inputF = (float*)malloc(maxChunk * sizeof(float));
+    float *outputF = (float*)malloc(maxChunk * sizeof(float));
+    if (!filters || !input || !output || !inputF || !outputF) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(filters);
+        free(input);
+        free(output);
+        free(inputF);
+        free(outputF);
+        return;
+    }
+    for (int n = 0; n < maxChunk; n++) {
+        input[n] = (double)rand() / RAND_MAX - 0.5;
+        inputF[n] = (float)input[n];
+    }
+
+    for (int d = 0; d < 4; d++) {
+        for (int c = 0; c < 2; c++) {
+            for (int j = 0; j < depths[d]; j++) {
+                lowpassSection(&filters[j]);
+            }
+            IIRCase iir = {filters, (size_t)depths[d], input, output, (size_t)chunks[c]};
+
+            char params[128];
+            snprintf(params, sizeof(params), "\"stages\": %d, \"chunk\": %d", depths[d], chunks[c]);
+            benchRun(suite, "IIR", "process_chunk", params, chunks[c], runIIR, &iir);
+
+            CascadeCase tdf2;
+            if (cascade_init(&tdf2.cascade, filters, depths[d]) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+                continue;
+            }
+            if (cascade_init_f(&tdf2.cascadeF, filters, depths[d]) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+                cascade_free(&tdf2.cascade);
+                continue;
+            }
+            tdf2.input = input;
+            tdf2.inputF = inputF;
+            tdf2.output = output;
+            tdf2.outputF = outputF;
+            tdf2.nSamples = chunks[c];
+            benchRun(suite, "IIR", "cascade_process", params, chunks[c], runCascade, &tdf2);
+            benchRun(suite, "IIR", "cascade_process_f", params, chunks[c], runCascadeF, &tdf2);
+            cascade_free(&tdf2.cascade);
+            cascade_free_f(&tdf2.cascadeF);
+
+            for (int blockSize = 4; blockSize <= 8; blockSize *= 2) {
+                BlockCase block;
+                if (block_init(&block.block, filters, depths[d], blockSize) != 0) {
+                    fprintf(stderr, "Failed to allocate memory\n");
+                    continue;
+                }
+                block.input = input;
+                block.output = output;
+                block.nSamples = chunks[c];
+                benchRun(suite, "IIR", blockSize == 4 ? "block_process L=4" : "block_process L=8", params, chunks[c],
+                         runBlock, &block);
+                block_free(&block.block);
+            }
+        }
+    }
+
+    reportCascadeAccuracy(filters, 64, input, maxChunk);
+    benchMultichannel(suite, filters);
+    benchSubnormals(suite, filters, output);
+
+    free(filters);
+    free(input);
+    free(output);
+    free(inputF);
+    free(outputF);
+}
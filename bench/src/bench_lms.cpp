@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/bench.h"
+#include "../../LMS/include/lms.h"
+#include "../../LMS/include/lmsBlock.h"
+
+typedef struct {
+    LMSFilter filter;
+    float *input;
+    float *output;
+    int nSamples;
+} LMSCase;
+
+static void runLMS(void *context) {
+    LMSCase *c = (LMSCase*)context;
+    processLMS(&c->filter, c->input, c->output, c->nSamples);
+}
+
+typedef struct {
+    LMSBlockFilter filter;
+    float *input;
+    float *output;
+    int nSamples;
+} LMSBlockCase;
+
+static void runLMSBlock(void *context) {
+    LMSBlockCase *c = (LMSBlockCase*)context;
+    lmsBlockProcess(&c->filter, NULL, c->input, c->output, c->nSamples);
+}
+
+// Results keep the kernel name pointer, so the labels have to be literals
+static const char *kernelLabel(const char *name) {
+    if (strcmp(name, "avx512") == 0) {
+        return "processLMS avx512";
+    }
+    return strcmp(name, "avx2") == 0 ? "processLMS avx2" : "processLMS scalar";
+}
+
+// Every kernel against the scalar one on the same input. 1027 taps is not a multiple
+// of 16, so the masked and scalar tails run too.
+static void reportKernelAccuracy(const float *input, int nSamples) {
+    const int numLMSCoeffs = 1027;
+    LMSKernelInfo kernels[3];
+    int numKernels = lmsAvailableKernels(kernels, 3);
+    float *expected = (float*)malloc(nSamples * sizeof(float));
+    float *actual = (float*)malloc(nSamples * sizeof(float));
+    if (!expected || !actual) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(expected);
+        free(actual);
+        return;
+    }
+
+    for (int i = 0; i < numKernels; i++) {
+        LMSFilter filter;
+        if (lmsInit(&filter, numLMSCoeffs, 0.0001f, 1000.0f, 48000.0f) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            lmsFree(&filter);
+            break;
+        }
+        filter.fused = kernels[i].fused;
+        processLMS(&filter, input, i == 0 ? expected : actual, nSamples);
+        lmsFree(&filter);
+
+        float maxError = 0.0f;
+        for (int n = 0; i > 0 && n < nSamples; n++) {
+            maxError = fmaxf(maxError, fabsf(actual[n] - expected[n]));
+        }
+        printf("LMS kernel %-8s max difference to scalar %.3g\n", kernels[i].name, maxError);
+    }
+    free(expected);
+    free(actual);
+}
+
+// Samples until the interferer residual stays 30 dB down, for LMS and NLMS over mu.
+// Input is a 1 kHz tone of amplitude 0.5 plus low-level noise, the residual is the
+// error minus that noise.
+static void reportConvergence(void) {
+    const int numSamples = 48000;
+    const int window = 32;
+    const int numLMSCoeffs = 32;
+    const float muLMS[] = {0.0002f, 0.002f, 0.02f, 0.2f};
+    const float muNLMS[] = {0.01f, 0.1f, 0.5f, 1.5f};
+
+    float *noise = (float*)malloc(numSamples * sizeof(float));
+    float *input = (float*)malloc(numSamples * sizeof(float));
+    float *output = (float*)malloc(numSamples * sizeof(float));
+    if (!noise || !input || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(noise);
+        free(input);
+        free(output);
+        return;
+    }
+    benchNoise(noise, numSamples);
+    for (int n = 0; n < numSamples; n++) {
+        noise[n] *= 0.01f;
+        input[n] = 0.5f * sinf(2.0f * (float)M_PI * 1000.0f * n / 48000.0f + 0.3f) + noise[n];
+    }
+    double tonePower = 0.125;
+
+    printf("LMS convergence, %d taps, samples until the residual stays 30 dB down\n", numLMSCoeffs);
+    for (int normalized = 0; normalized < 2; normalized++) {
+        for (int m = 0; m < 4; m++) {
+            float mu = normalized ? muNLMS[m] : muLMS[m];
+            LMSFilter filter;
+            if (lmsInit(&filter, numLMSCoeffs, mu, 1000.0f, 48000.0f) != 0) {
+                fprintf(stderr, "Failed to allocate memory\n");
+                lmsFree(&filter);
+                continue;
+            }
+            filter.normalized = normalized != 0;
+            processLMS(&filter, input, output, numSamples);
+            lmsFree(&filter);
+
+            // Last window start above the threshold, the residual stays below after it
+            int converged = 0;
+            bool diverged = false;
+            for (int start = 0; start + window <= numSamples; start += window) {
+                double power = 0.0;
+                for (int n = start; n < start + window; n++) {
+                    double residual = output[n] - noise[n];
+                    power += residual * residual;
+                }
+                power /= window;
+                diverged = diverged || !(power < 1e6);
+                if (!(power < 1e-3 * tonePower)) {
+                    converged = start + window;
+                }
+            }
+            if (diverged) {
+                printf("%-5s mu=%-6g diverged\n", normalized ? "NLMS" : "LMS", mu);
+            } else if (converged >= numSamples) {
+                printf("%-5s mu=%-6g not converged after %d samples\n", normalized ? "NLMS" : "LMS", mu, numSamples);
+            } else {
+                printf("%-5s mu=%-6g %6d samples\n", normalized ? "NLMS" : "LMS", mu, converged);
+            }
+        }
+    }
+    free(noise);
+    free(input);
+    free(output);
+}
+
+// Residual power over time of the time-domain and the block engines on a long filter.
+// Same tone plus noise input as reportConvergence, 1024 taps, block size 1024.
+static void reportBlockConvergence(void) {
+    const int numSamples = 5 * 48000;
+    const int window = 8192;
+    const int numLMSCoeffs = 1024;
+    const int blockSize = 1024;
+
+    float *noise = (float*)malloc(numSamples * sizeof(float));
+    float *input = (float*)malloc(numSamples * sizeof(float));
+    float *output = (float*)malloc(4 * numSamples * sizeof(float));
+    if (!noise || !input || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(noise);
+        free(input);
+        free(output);
+        return;
+    }
+    benchNoise(noise, numSamples);
+    for (int n = 0; n < numSamples; n++) {
+        noise[n] *= 0.01f;
+        input[n] = 0.5f * sinf(2.0f * (float)M_PI * 1000.0f * n / 48000.0f + 0.3f) + noise[n];
+    }
+
+    // LMS and block LMS share a mu that is stable for 1024 taps, the normalized ones use 0.5
+    for (int e = 0; e < 4; e++) {
+        float mu = (e % 2 == 0) ? 0.0005f : 0.5f;
+        float *out = output + e * numSamples;
+        if (e < 2) {
+            LMSFilter filter;
+            if (lmsInit(&filter, numLMSCoeffs, mu, 1000.0f, 48000.0f) == 0) {
+                filter.normalized = (e == 1);
+                for (int start = 0; start < numSamples; start += blockSize) {
+                    processLMS(&filter, input + start, out + start, blockSize);
+                }
+            }
+            lmsFree(&filter);
+        } else {
+            LMSBlockFilter filter;
+            if (lmsBlockInit(&filter, numLMSCoeffs, blockSize, mu, 1000.0f, 48000.0f) == 0) {
+                filter.normalized = (e == 3);
+                lmsBlockProcess(&filter, NULL, input, out, numSamples);
+            }
+            lmsBlockFree(&filter);
+        }
+    }
+
+    printf("LMS convergence, %d taps, block %d, residual in dB re the tone per %d samples\n", numLMSCoeffs, blockSize, window);
+    printf("%8s %10s %10s %10s %10s\n", "seconds", "LMS", "NLMS", "block", "block norm");
+    for (int start = 0; start + window <= numSamples; start += window) {
+        printf("%8.2f", (double)(start + window) / 48000.0);
+        for (int e = 0; e < 4; e++) {
+            double power = 0.0;
+            for (int n = start; n < start + window; n++) {
+                double residual = output[e * numSamples + n] - noise[n];
+                power += residual * residual;
+            }
+            printf(" %10.1f", 10.0 * log10(power / window / 0.125 + 1e-30));
+        }
+        printf("\n");
+    }
+    free(noise);
+    free(input);
+    free(output);
+}
+
+// processLMS over tap count and chunk size, with every fused kernel the host supports
+void benchLMS(BenchSuite *suite) {
+    const int taps[] = {8, 32, 128, 1024, 4096};
+    const int chunks[] = {256, 1024};
+    const int maxChunk = 1024;
+
+    float *input = (float*)malloc(maxChunk * sizeof(float));
+    float *output = (float*)malloc(maxChunk * sizeof(float));
+    if (!input || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        free(input);
+        free(output);
+        return;
+    }
+    benchNoise(input, maxChunk);
+
+    LMSKernelInfo kernels[3];
+    int numKernels = lmsAvailableKernels(kernels, 3);
+    for (int t = 0; t < 5; t++) {
+        for (int c = 0; c < 2; c++) {
+            char params[128];
+            snprintf(params, sizeof(params), "\"taps\": %d, \"chunk\": %d", taps[t], chunks[c]);
+
+            // numKernels is the normalized step with the selected kernel
+            for (int i = 0; i <= numKernels; i++) {
+                LMSCase lms;
+                if (lmsInit(&lms.filter, taps[t], 0.001f, 1000.0f, 48000.0f) != 0) {
+                    fprintf(stderr, "Failed to allocate memory\n");
+                    lmsFree(&lms.filter);
+                    continue;
+                }
+                const char *kernel = "processLMS nlms";
+                if (i < numKernels) {
+                    lms.filter.fused = kernels[i].fused;
+                    kernel = kernelLabel(kernels[i].name);
+                } else {
+                    lms.filter.normalized = true;
+                }
+                lms.input = input;
+                lms.output = output;
+                lms.nSamples = chunks[c];
+                benchRun(suite, "LMS", kernel, params, chunks[c], runLMS, &lms);
+                lmsFree(&lms.filter);
+            }
+        }
+    }
+
+    // Bank of notches for hum and harmonics, one pass for all tones
+    const float harmonics[] = {50.0f, 100.0f, 150.0f, 200.0f, 250.0f, 300.0f, 350.0f, 400.0f};
+    const int toneCounts[] = {1, 4, 8};
+    for (int i = 0; i < 3; i++) {
+        LMSCase lms;
+        if (lmsInitMultiTone(&lms.filter, 32, 0.001f, harmonics, toneCounts[i], 48000.0f) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            lmsFree(&lms.filter);
+            continue;
+        }
+        lms.input = input;
+        lms.output = output;
+        lms.nSamples = maxChunk;
+
+        char params[128];
+        snprintf(params, sizeof(params), "\"taps\": 32, \"tones\": %d, \"chunk\": %d", toneCounts[i], maxChunk);
+        benchRun(suite, "LMS", "processLMS multitone", params, maxChunk, runLMS, &lms);
+        lmsFree(&lms.filter);
+    }
+
+    // Frequency-domain block LMS, the chunk is the block. It is cheapest with the
+    // block as long as the filter, one FFT size then serves both.
+    const int blockTaps[] = {128, 1024, 4096, 4096};
+    const int blockSizes[] = {1024, 1024, 1024, 4096};
+    float *blockInput = (float*)malloc(4096 * sizeof(float));
+    float *blockOutput = (float*)malloc(4096 * sizeof(float));
+    for (int t = 0; t < 4 && blockInput && blockOutput; t++) {
+        LMSBlockCase block;
+        if (lmsBlockInit(&block.filter, blockTaps[t], blockSizes[t], 0.001f, 1000.0f, 48000.0f) != 0) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            lmsBlockFree(&block.filter);
+            continue;
+        }
+        benchNoise(blockInput, blockSizes[t]);
+        block.input = blockInput;
+        block.output = blockOutput;
+        block.nSamples = blockSizes[t];
+
+        char params[128];
+        snprintf(params, sizeof(params), "\"taps\": %d, \"chunk\": %d", blockTaps[t], blockSizes[t]);
+        benchRun(suite, "LMS", "lmsBlockProcess", params, blockSizes[t], runLMSBlock, &block);
+        lmsBlockFree(&block.filter);
+    }
+    free(blockInput);
+    free(blockOutput);
+
+    reportKernelAccuracy(input, maxChunk);
+    reportConvergence();
+    reportBlockConvergence();
+
+    free(input);
+    free(output);
+}
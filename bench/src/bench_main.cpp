@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/bench.h"
+
+typedef struct {
+    const char *name;
+    void (*run)(BenchSuite *suite);
+} BenchModule;
+
+static const BenchModule modules[] = {
+    {"FIR", benchFIR},
+    {"IIR", benchIIR},
+    {"LMS", benchLMS},
+    {"Downsampling", benchDownsampling},
+    {"InstFreq", benchInstFreq},
+    {"DFT", benchDFT},
+};
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "Usage: %s <output json file> [min seconds per case] [module]\n", argv[0]);
+        return 1;
+    }
+
+    // Read command line arguments
+    char *outputFile = argv[1];
+    double minSeconds = (argc > 2) ? atof(argv[2]) : 0.2;
+    const char *onlyModule = (argc > 3) ? argv[3] : NULL;
+    if (minSeconds <= 0.0) {
+        fprintf(stderr, "Error: Invalid arguments. Ensure all values are positive.\n");
+        return 1;
+    }
+
+    BenchSuite suite;
+    if (benchInit(&suite, minSeconds) != 0) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return -1;
+    }
+
+    // Same input data on every run
+    srand(1);
+    int numRun = 0;
+    for (size_t m = 0; m < sizeof(modules) / sizeof(modules[0]); m++) {
+        if (onlyModule && strcmp(onlyModule, modules[m].name) != 0) {
+            continue;
+        }
+        modules[m].run(&suite);
+        numRun++;
+    }
+    if (numRun == 0) {
+        fprintf(stderr, "Unknown module: %s\n", onlyModule);
+        benchFree(&suite);
+        return 1;
+    }
+
+    int status = benchWriteJSON(&suite, outputFile);
+    if (status == 0) {
+        printf("%d results saved in %s\n", suite.numResults, outputFile);
+    }
+    benchFree(&suite);
+    return status;
+}